@@ -17,6 +17,15 @@
  */
 
 #include <string>
+#include <vector>
+#include <map>
+#include <thread>
+#include <algorithm>
+#include <cstring>
+#include <cerrno>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
 #include <boost/filesystem.hpp>
 #include <tclap/CmdLine.h>
 
@@ -34,10 +43,21 @@ using namespace ibmisc;
 using namespace netCDF;
 
 struct ParseArgs {
+    // ----- Single mode: overlap one gridA with one gridI
     std::string fnameA;
     std::string fnameI;
     std::string fname_exgrid;    // OUT: Name of overlap file to write
 
+    // ----- Batch mode: overlap every gridA with every gridI
+    std::vector<std::string> batchA;
+    std::vector<std::string> batchI;
+    std::string outdir;          // Directory for batch overlap files
+    int nproc;                   // Number of (A,I) pairs to overlap at once
+
+    /** Instead of copying gridA into each overlap file, write a
+    reference to the file it was read from. */
+    bool ref_gridA;
+
     ParseArgs(int argc, char **argv);
 };
 
@@ -56,17 +76,37 @@ ParseArgs::ParseArgs(int argc, char **argv)
 
         TCLAP::UnlabeledValueArg<std::string> fnameA_a("gridA",
             "Name of file containing Atmosphere grid",
-            true, "", "atmosphere grid file", cmd);
+            false, "", "atmosphere grid file", cmd);
 
         TCLAP::UnlabeledValueArg<std::string> fnameI_a("gridI",
             "Name of file containing Ice grid",
-            true, "", "ice grid file", cmd);
+            false, "", "ice grid file", cmd);
 
 
         TCLAP::ValueArg<std::string> fname_exgrid_a("o", "out",
             "Name of IceBin overlap file to write",
             false, "", "overlap grid file", cmd);
 
+        TCLAP::MultiArg<std::string> batchA_a("a", "batchA",
+            "Batch mode: Atmosphere grid file (may be repeated)",
+            false, "atmosphere grid file", cmd);
+
+        TCLAP::MultiArg<std::string> batchI_a("i", "batchI",
+            "Batch mode: Ice grid file (may be repeated)",
+            false, "ice grid file", cmd);
+
+        TCLAP::ValueArg<std::string> outdir_a("d", "outdir",
+            "Batch mode: Directory in which to write overlap files",
+            false, ".", "output directory", cmd);
+
+        TCLAP::ValueArg<int> nproc_a("j", "jobs",
+            "Batch mode: Number of overlaps to compute concurrently, each in its own process (0 = number of cores)",
+            false, 0, "number of processes", cmd);
+
+        TCLAP::SwitchArg ref_gridA_a("r", "ref-gridA",
+            "Store a reference to the gridA file, rather than gridA itself",
+            cmd, false);
+
 
         // Parse the argv array.
         cmd.parse( argc, argv );
@@ -74,44 +114,162 @@ ParseArgs::ParseArgs(int argc, char **argv)
         fnameA = fnameA_a.getValue();
         fnameI = fnameI_a.getValue();
         fname_exgrid = fname_exgrid_a.getValue();
+        batchA = batchA_a.getValue();
+        batchI = batchI_a.getValue();
+        outdir = outdir_a.getValue();
+        nproc = nproc_a.getValue();
+        ref_gridA = ref_gridA_a.getValue();
     } catch (TCLAP::ArgException &e) { // catch any exceptions
         std::cerr << "error: " << e.error() << " for arg " << e.argId() << std::endl;
         exit(1);
     }
-}
 
+    bool const single = (fnameA != "" || fnameI != "");
+    bool const batch = (batchA.size() > 0 || batchI.size() > 0);
+    if (single == batch
+        || (single && (fnameA == "" || fnameI == ""))
+        || (batch && (batchA.size() == 0 || batchI.size() == 0)))
+    {
+        std::cerr << "error: Specify either <gridA> <gridI>, or at least one each of -a and -i" << std::endl;
+        exit(1);
+    }
+    if (batch && fname_exgrid != "") {
+        std::cerr << "error: -o may not be used in batch mode; use -d" << std::endl;
+        exit(1);
+    }
+}
 
-int main(int argc, char **argv)
+static std::unique_ptr<Grid> read_grid(std::string const &fname)
 {
-    ParseArgs args(argc, argv);
+    printf("------------- Read grid: %s\n", fname.c_str());
+    std::unique_ptr<Grid> grid(new Grid);
+    NcIO ncio(fname, 'r');
+    grid->ncio(ncio, "grid");
+    ncio.close();
+    printf("Done reading %s\n", fname.c_str());
+    return grid;
+}
 
-    printf("------------- Read gridA (GCM Grid): %s\n", args.fnameA.c_str());
-    NcIO ncio1(args.fnameA, 'r');
-    Grid gridA;
-    gridA.ncio(ncio1, "grid");
-    ncio1.close();
-    printf("Done reading gridA\n");
-
-    printf("------------- Read gridI (Ice Grid): %s\n", args.fnameI.c_str());
-    NcIO ncio2(args.fnameI, 'r');
-    Grid gridI;
-    gridI.ncio(ncio2, "grid");
-    ncio2.close();
-    printf("Done reading gridI\n");
-
-    printf("--------------- Overlapping\n");
-    Grid exgrid(make_exchange_grid(&gridA, &gridI));
-    sort_renumber_vertices(exgrid);
-
-    printf("--------------- Writing out\n");
-    std::string fname(args.fname_exgrid);
-    if (fname == "")
-        fname = strprintf("%s.nc", exgrid.name.c_str());    // Using operator+() or append() doesn't work here with GCC 4.9.3
-
-    printf("overlap writing to %s", fname.c_str());
+/** Writes an overlap file.  If fnameA is non-empty, gridA is stored
+by reference to the file it was read from (variable "grid"), rather
+than being copied; Grid::ncio() follows the reference on read. */
+static void write_overlap(
+    std::string const &fname,
+    Grid &gridA, std::string const &fnameA,
+    Grid &gridI,
+    Grid &exgrid)
+{
+    printf("overlap writing to %s\n", fname.c_str());
     ibmisc::NcIO ncio(fname, 'w');
-    gridA.ncio(ncio, "gridA");
+    if (fnameA == "") {
+        gridA.ncio(ncio, "gridA");
+    } else {
+        write_grid_ref(ncio, "gridA", fnameA, "grid");
+    }
     gridI.ncio(ncio, "gridI");
     exgrid.ncio(ncio, "exgrid");
     ncio.close();
 }
+
+int main(int argc, char **argv)
+{
+    ParseArgs args(argc, argv);
+
+    // ------------- Single mode
+    if (args.fnameA != "") {
+        std::unique_ptr<Grid> gridA(read_grid(args.fnameA));
+        std::unique_ptr<Grid> gridI(read_grid(args.fnameI));
+
+        printf("--------------- Overlapping\n");
+        Grid exgrid(make_exchange_grid(&*gridA, &*gridI));
+        sort_renumber_vertices(exgrid);
+
+        printf("--------------- Writing out\n");
+        std::string fname(args.fname_exgrid);
+        if (fname == "")
+            fname = strprintf("%s.nc", exgrid.name.c_str());    // Using operator+() or append() doesn't work here with GCC 4.9.3
+
+        write_overlap(fname, *gridA, args.ref_gridA ? args.fnameA : "", *gridI, exgrid);
+        return 0;
+    }
+
+    // ------------- Batch mode
+    // Read each grid just once, no matter how many pairs it is in.
+    std::vector<std::unique_ptr<Grid>> gridAs, gridIs;
+    for (auto const &fname : args.batchA) gridAs.push_back(read_grid(fname));
+    for (auto const &fname : args.batchI) gridIs.push_back(read_grid(fname));
+
+    size_t const njob = gridAs.size() * gridIs.size();
+    int nproc = args.nproc;
+    if (nproc <= 0) nproc = std::max(1u, std::thread::hardware_concurrency());
+    nproc = std::min((size_t)nproc, njob);
+
+    // Each (A,I) pair is overlapped in its own forked process, which
+    // sees the grids read above (copy-on-write) and writes its own
+    // overlap file.  Overlap code (CGAL lazy-exact kernel, Proj) is
+    // not known to be thread-safe, and icebin_error exits the
+    // process; so a failure in one pair cannot take down the others.
+    std::map<pid_t, size_t> running;    // pid -> job
+    std::vector<std::string> errors;
+    auto job_name = [&](size_t job) {
+        return strprintf("%s - %s",
+            args.batchA[job / gridIs.size()].c_str(),
+            args.batchI[job % gridIs.size()].c_str());
+    };
+
+    size_t next_job = 0;
+    while (next_job < njob || running.size() > 0) {
+        // Start jobs, up to nproc at once
+        while (next_job < njob && running.size() < (size_t)nproc) {
+            size_t const job = next_job++;
+            fflush(stdout);
+            fflush(stderr);
+            pid_t const pid = fork();
+            if (pid < 0) {
+                errors.push_back(strprintf("%s: fork() failed: %s",
+                    job_name(job).c_str(), strerror(errno)));
+                continue;
+            }
+            if (pid == 0) {
+                size_t const iA = job / gridIs.size();
+                size_t const iI = job % gridIs.size();
+                Grid &gridA(*gridAs[iA]);
+                Grid &gridI(*gridIs[iI]);
+
+                printf("--------------- Overlapping %s with %s\n",
+                    gridA.name.c_str(), gridI.name.c_str());
+                Grid exgrid(make_exchange_grid(&gridA, &gridI));
+                sort_renumber_vertices(exgrid);
+
+                std::string fname((boost::filesystem::path(args.outdir)
+                    / (exgrid.name + ".nc")).string());
+                write_overlap(fname, gridA, args.ref_gridA ? args.batchA[iA] : "",
+                    gridI, exgrid);
+                fflush(stdout);
+                _exit(0);
+            }
+            running[pid] = job;
+        }
+
+        // Collect a finished job
+        int status;
+        pid_t const pid = wait(&status);
+        if (pid < 0) {
+            if (errno == EINTR) continue;
+            break;    // ECHILD: nothing left running
+        }
+        auto ii(running.find(pid));
+        if (ii == running.end()) continue;
+        if (WIFSIGNALED(status)) {
+            errors.push_back(strprintf("%s: killed by signal %d",
+                job_name(ii->second).c_str(), WTERMSIG(status)));
+        } else if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            errors.push_back(strprintf("%s: exited with status %d",
+                job_name(ii->second).c_str(), WEXITSTATUS(status)));
+        }
+        running.erase(ii);
+    }
+
+    for (std::string const &err : errors) fprintf(stderr, "ERROR: %s\n", err.c_str());
+    return errors.size() > 0 ? -1 : 0;
+}
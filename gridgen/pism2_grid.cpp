@@ -16,8 +16,9 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
-// Generates PISM grid as of year 2019
+// Generates PISM grid as of year 2019; or the grid of any PISM state file.
 
+#include <cstdint>
 #include <string>
 #include <ctype.h>
 #include <algorithm>
@@ -29,11 +30,13 @@
 
 #include <ibmisc/enum.hpp>
 #include <ibmisc/stdio.hpp>
+#include <ibmisc/netcdf.hpp>
 
 #include <icebin/error.hpp>
 #include <icebin/gridgen/gridutil.hpp>
 #include <icebin/gridgen/clippers.hpp>
 #include <icebin/gridgen/GridGen_XY.hpp>
+#include <icebin/gridgen/GridGen_Exchange.hpp>
 
 using namespace std::placeholders;  // for _1, _2, _3...
 using namespace ibmisc;
@@ -48,6 +51,160 @@ BOOST_ENUM_VALUES(Zone, int,
     (antarctica) (1)
 )
 
+// -------------------------------------------------------------
+/** Reads a 1-D coordinate variable (cell centers), converted to [m] */
+static std::vector<double> read_coord(netCDF::NcFile &nc, std::string const &vname)
+{
+    netCDF::NcVar var(nc.getVar(vname));
+    if (var.isNull()) (*icebin_error)(-1,
+        "PISM state file has no variable %s", vname.c_str());
+
+    std::vector<double> centers(var.getDim(0).getSize());
+    var.getVar(centers.data());
+
+    std::string units("m");
+    auto units_att(var.getAtts());
+    if (units_att.find("units") != units_att.end()) units_att.at("units").getValues(units);
+    if (units == "km") for (double &c : centers) c *= km;
+    else if (units != "m" && units != "meters") (*icebin_error)(-1,
+        "Unsupported units for %s: %s", vname.c_str(), units.c_str());
+
+    return centers;
+}
+
+/** Converts cell centers to cell boundaries, extrapolating at the ends. */
+static std::vector<double> centers_to_boundaries(std::vector<double> const &centers)
+{
+    size_t const n = centers.size();
+    if (n < 2) (*icebin_error)(-1, "Need at least 2 cell centers, got %ld", (long)n);
+
+    std::vector<double> bounds;
+    bounds.reserve(n+1);
+    bounds.push_back(centers[0] - .5*(centers[1] - centers[0]));
+    for (size_t i=1; i<n; ++i) bounds.push_back(.5*(centers[i-1] + centers[i]));
+    bounds.push_back(centers[n-1] + .5*(centers[n-1] - centers[n-2]));
+    return bounds;
+}
+
+/** Finds the Proj.4 string in a PISM state file.  Depending on PISM
+version, it is in global attribute "proj" or "proj4", or attribute
+"proj4" / "proj_params" of the "mapping" variable. */
+static std::string read_proj(netCDF::NcFile &nc)
+{
+    std::string sproj;
+    auto gatts(nc.getAtts());
+    for (std::string const attname : {"proj", "proj4"}) {
+        auto ii(gatts.find(attname));
+        if (ii != gatts.end()) {
+            ii->second.getValues(sproj);
+            return sproj;
+        }
+    }
+
+    netCDF::NcVar mapping(nc.getVar("mapping"));
+    if (!mapping.isNull()) {
+        auto atts(mapping.getAtts());
+        for (std::string const attname : {"proj4", "proj_params"}) {
+            auto ii(atts.find(attname));
+            if (ii != atts.end()) {
+                ii->second.getValues(sproj);
+                return sproj;
+            }
+        }
+    }
+
+    (*icebin_error)(-1, "Cannot find projection in PISM state file");
+    return sproj;
+}
+
+/** Builds the spec of the grid a PISM state file is on.  PISM stores
+fields as (time, y, x), so y has the largest stride. */
+static GridSpec_XY spec_from_pism_state(std::string const &fname)
+{
+    printf("Reading grid from PISM state file %s\n", fname.c_str());
+    NcIO ncio(fname, 'r');
+    std::string const sproj(read_proj(*ncio.nc));
+    std::vector<double> xb(centers_to_boundaries(read_coord(*ncio.nc, "x")));
+    std::vector<double> yb(centers_to_boundaries(read_coord(*ncio.nc, "y")));
+    ncio.close();
+
+    return GridSpec_XY(sproj, std::vector<int>{1,0}, std::move(xb), std::move(yb));
+}
+
+// -------------------------------------------------------------
+/** 64-bit FNV-1a; stable across builds, unlike std::hash */
+struct SpecHash {
+    uint64_t h = 14695981039346656037ULL;
+
+    void add(void const *data, size_t n) {
+        auto const *bytes(static_cast<unsigned char const *>(data));
+        for (size_t i=0; i<n; ++i) {
+            h ^= bytes[i];
+            h *= 1099511628211ULL;
+        }
+    }
+    void add(std::string const &s) { add(s.data(), s.size()+1); }
+    template<class T>
+    void add(std::vector<T> const &v) { add(v.data(), v.size() * sizeof(T)); }
+};
+
+/** Hash of everything that determines the exchange grid between
+gridA (identified by its file) and the ice grid spec. */
+static uint64_t exgrid_hash(std::string const &fnameA, GridSpec_XY const &specI)
+{
+    SpecHash hash;
+    hash.add(boost::filesystem::absolute(fnameA).string());
+    long const mtimeA = boost::filesystem::last_write_time(fnameA);
+    hash.add(&mtimeA, sizeof(mtimeA));
+    hash.add(specI.sproj);
+    hash.add(specI.indices);
+    hash.add(specI.xb);
+    hash.add(specI.yb);
+    return hash.h;
+}
+
+/** Writes the exchange grid between gridA and gridI into cache_dir,
+unless an up-to-date one (same spec hash) is already there.
+@return Name of the exchange grid file. */
+static std::string cached_exgrid(
+    std::string const &fnameA,
+    Grid &gridI,
+    GridSpec_XY const &specI,
+    std::string const &cache_dir)
+{
+    std::string const fname((boost::filesystem::path(cache_dir) / strprintf(
+        "exgrid-%s-%016llx.nc",
+        boost::filesystem::path(fnameA).stem().string().c_str(),
+        (unsigned long long)exgrid_hash(fnameA, specI))).string());
+
+    if (boost::filesystem::exists(fname)) {
+        printf("Reusing cached exchange grid %s\n", fname.c_str());
+        return fname;
+    }
+
+    printf("------------- Read grid: %s\n", fnameA.c_str());
+    Grid gridA;
+    {NcIO ncio(fnameA, 'r');
+        gridA.ncio(ncio, "grid");
+    }
+
+    printf("--------------- Overlapping\n");
+    Grid exgrid(make_exchange_grid(&gridA, &gridI));
+    sort_renumber_vertices(exgrid);
+
+    // Write to a temporary file and rename, so an interrupted run
+    // never leaves a partial file that looks like a cache hit.
+    std::string const tmp_fname(fname + ".tmp");
+    printf("Writing exchange grid %s\n", fname.c_str());
+    {NcIO ncio(tmp_fname, netCDF::NcFile::replace);
+        gridA.ncio(ncio, "gridA");
+        gridI.ncio(ncio, "gridI");
+        exgrid.ncio(ncio, "exgrid");
+    }
+    boost::filesystem::rename(tmp_fname, fname);
+    return fname;
+}
+
 int main(int argc, char **argv)
 {
     // -------------------------------------------------------------
@@ -59,7 +216,11 @@ int main(int argc, char **argv)
     desc.add_options()
         ("help", "produce help message")
         ("zone", po::value<std::string>(), "Greenland or Antarctica")
-        ("out,o", po::value<std::string>(), "Greenland or Antarctica");
+        ("state,s", po::value<std::string>(), "PISM state file to take the grid (x, y, projection) from")
+        ("name", po::value<std::string>(), "Name of the generated grid")
+        ("gridA,a", po::value<std::string>(), "GCM grid file; also generate the exchange grid with it")
+        ("cache-dir", po::value<std::string>()->default_value("."), "Directory for cached exchange grids")
+        ("out,o", po::value<std::string>(), "Output grid file");
 
     po::variables_map vm;
     po::store(po::parse_command_line(argc, argv, desc), vm);
@@ -91,7 +252,9 @@ int main(int argc, char **argv)
     std::vector<int> const indices {1,0};
 
     GridSpec_XY spec;
-    if (zone == Zone::greenland) {
+    if (vm.count("state")) {
+        spec = spec_from_pism_state(vm["state"].as<std::string>());
+    } else if (zone == Zone::greenland) {
         spec = GridSpec_XY::make_with_boundaries(
             //"+init='EPSG:3413'",
             "+proj=stere +lat_0=90 +lat_ts=70 +lon_0=-45 +k=1 +x_0=0 +y_0=0 +datum=WGS84 +units=m +no_defs",
@@ -109,7 +272,10 @@ int main(int argc, char **argv)
     }
 
     // ------------ Make the grid from the spec
-    std::string name(ibmisc::strprintf("pism2_g%d_%s", 20, "pism2"));
+    std::string name(vm.count("name") ? vm["name"].as<std::string>()
+        : vm.count("state") ? ibmisc::strprintf("pism_g%g",
+            (spec.xb[1] - spec.xb[0]) / km)
+        : ibmisc::strprintf("pism2_g%d_%s", 20, "pism2"));
     Grid grid(make_grid(name, spec, &EuclidianClip::keep_all));
 
     // ------------- Write it out to NetCDF
@@ -118,4 +284,12 @@ int main(int argc, char **argv)
     ibmisc::NcIO ncio(ofname, netCDF::NcFile::replace);
     grid.ncio(ncio, "grid");
     ncio.close();
+
+    // ------------- Exchange grid with the GCM grid (cached)
+    if (vm.count("gridA")) {
+        std::string const exgrid_fname(cached_exgrid(
+            vm["gridA"].as<std::string>(), grid, spec,
+            vm["cache-dir"].as<std::string>()));
+        printf("Exchange grid: %s\n", exgrid_fname.c_str());
+    }
 }
@@ -0,0 +1,375 @@
+/*
+MPI scaling benchmark for the ModelE coupling path.
+
+Calls gcmce_couple_native() on synthetic data, so the cost of the
+coupling path can be measured against rank count and grid size without
+ModelE or any input files.  Everything except the ice side runs the
+real code: packing gcm_ovalsE, gather, split_by_domain(),
+compact_for_scatter(), scatter, apply_gcm_ivals() and
+export_E1vE0c().
+
+  * The A grid is im x jm, with nhc elevation classes; it is split
+    among MPI ranks in latitude bands (as ModelE does).  Each rank
+    allocates its ModelE-style arrays for its own band, as
+    gcmce_add_gcm_outpute() / gcmce_add_gcm_inputa() / _inpute() would
+    receive them.
+  * Every frac_ice'th gridcell is ice-covered (underice_d=UI_LOCALICE).
+  * The ice side is stubbed out: on root, couple() (the ice couplers
+    plus update_topo()) is replaced by one that fabricates a GCMInput
+    of the size a real coupling step would return (A, E, ATOPO and
+    ETOPO variables, plus an E1vE0c matrix coupling adjacent
+    elevation classes).  It needs no ice grids or regrid matrices.
+
+Reports wall time per coupling step (on root, and max over ranks) for
+each phase of gcmce_couple_native() (see CouplePhase), as reported by
+its on_phase hook; and the bytes put on the wire by each rank.  Time
+spent measuring message sizes is left out.
+
+Example:
+    mpirun -np 8 couple_bench --im 288 --jm 180 --nhc 15 --steps 10
+*/
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <limits>
+#include <string>
+#include <vector>
+#include <mpi.h>        // Intel MPI wants to be first
+#include <boost/mpi.hpp>
+#include <boost/mpi/packed_oarchive.hpp>
+#include <boost/serialization/vector.hpp>
+#include <tclap/CmdLine.h>
+
+#include <icebin/GCMCoupler.hpp>
+#include <icebin/GCMRegridder.hpp>
+#include <icebin/multivec.hpp>
+#include <icebin/modele/GCMCoupler_ModelE.hpp>
+#include <icebin/modele/grids.hpp>
+
+using namespace std;
+using namespace ibmisc;
+using namespace icebin;
+using namespace icebin::modele;
+
+// ==========================================================
+struct ParseArgs {
+    int im, jm, nhc;
+    int nvarA, nvarE, nvar_topo;
+    int frac_ice;
+    int steps;
+    bool scatter_float;
+
+    ParseArgs(int argc, char **argv);
+};
+
+ParseArgs::ParseArgs(int argc, char **argv)
+{
+    try {
+        TCLAP::CmdLine cmd("Synthetic benchmark of the ModelE coupling path", ' ', "<no-version>");
+
+        TCLAP::ValueArg<int> im_a("", "im", "Longitude gridcells of A grid", false, 144, "int", cmd);
+        TCLAP::ValueArg<int> jm_a("", "jm", "Latitude gridcells of A grid", false, 90, "int", cmd);
+        TCLAP::ValueArg<int> nhc_a("", "nhc", "Number of elevation classes", false, 15, "int", cmd);
+        TCLAP::ValueArg<int> nvarA_a("", "nvarA", "Number of GCM inputs on A grid", false, 3, "int", cmd);
+        TCLAP::ValueArg<int> nvarE_a("", "nvarE", "Number of GCM inputs/outputs on E grid", false, 4, "int", cmd);
+        TCLAP::ValueArg<int> nvar_topo_a("", "nvar-topo", "Number of TOPO variables on each of A and E", false, 3, "int", cmd);
+        TCLAP::ValueArg<int> frac_ice_a("", "frac-ice", "One in this many A gridcells is ice-covered", false, 4, "int", cmd);
+        TCLAP::ValueArg<int> steps_a("", "steps", "Number of coupling steps to time", false, 5, "int", cmd);
+        TCLAP::SwitchArg float_a("", "float", "Scatter values in single precision (see gcmce_set_scatter_float)", cmd, false);
+
+        cmd.parse(argc, argv);
+
+        im = im_a.getValue();
+        jm = jm_a.getValue();
+        nhc = nhc_a.getValue();
+        nvarA = nvarA_a.getValue();
+        nvarE = nvarE_a.getValue();
+        nvar_topo = nvar_topo_a.getValue();
+        frac_ice = frac_ice_a.getValue();
+        steps = steps_a.getValue();
+        scatter_float = float_a.getValue();
+    } catch (TCLAP::ArgException &e) { // catch any exceptions
+        std::cerr << "error: " << e.error() << " for arg " << e.argId() << std::endl;
+        exit(1);
+    }
+}
+// ==========================================================
+
+// Times per step: one per CouplePhase, then the total
+static int const TOTAL = (int)CouplePhase::COUNT;
+static int const NPHASE = TOTAL + 1;
+static std::array<char const *, NPHASE> const phase_names
+    {"pack", "gather", "couple", "split", "compact", "scatter", "apply", "total"};
+
+/** Number of bytes an object occupies in a Boost.MPI message */
+template<class T>
+static size_t wire_bytes(boost::mpi::communicator const &world, T const &obj)
+{
+    boost::mpi::packed_oarchive oa(world);
+    oa << obj;
+    return oa.size();
+}
+
+static bool is_ice(ParseArgs const &args, long iA)
+    { return iA % args.frac_ice == 0; }
+
+/** GCMCoupler_ModelE with the ice side stubbed out.  couple() is the
+only override; gcmce_couple_native() runs unchanged around it. */
+class BenchCoupler : public GCMCoupler_ModelE {
+public:
+    ParseArgs const &args;
+
+    // ------- Accumulated over all coupling steps, via on_phase
+    std::vector<double> phase_time;    // Per CouplePhase
+    double measured_time = 0;   // Time spent measuring message sizes
+
+    // ------- Measured during the last coupling step
+    double measure_time = 0;    // Measuring time not yet charged to a phase
+    size_t gather_bytes = 0;    // This rank's gcm_ovalsE on the wire
+    size_t scatter_bytes = 0;   // On root: all ranks' GCMInput on the wire
+
+    BenchCoupler(ParseArgs const &_args, boost::mpi::communicator const &world);
+
+    /** Stand-in for GCMCoupler_ModelE::couple() on root: produces a
+    GCMInput the size of what a real coupling step returns, for all
+    ice-covered gridcells. */
+    GCMInput couple(
+        double time_s,
+        VectorMultivec const &gcm_ovalsE,
+        bool run_ice) override;
+};
+
+BenchCoupler::BenchCoupler(ParseArgs const &_args, boost::mpi::communicator const &world)
+    : GCMCoupler_ModelE(GCMParams(MPI_Comm(world), 0)), args(_args),
+    phase_time((int)CouplePhase::COUNT, 0.)
+{
+    long const nA = (long)args.im * args.jm;
+    dtsrc = 1800.;
+    gcm_params.icebin_logging = false;
+    gcm_params.scatter_float = args.scatter_float;
+
+    // ----------- Instrumentation hooks in gcmce_couple_native()
+    // Measuring is charged to no phase.
+    on_phase = [this](CouplePhase phase, double seconds) {
+        phase_time[(int)phase] += seconds - measure_time;
+        measured_time += measure_time;
+        measure_time = 0;
+    };
+    // This rank's own message, before root concatenates them
+    on_gather = [this](VectorMultivec const &gcm_ovalsE_s) {
+        double const t0 = MPI_Wtime();
+        gather_bytes = wire_bytes(gcm_params.world, gcm_ovalsE_s);
+        measure_time += MPI_Wtime() - t0;
+    };
+
+    // ----------- Regridder: just enough for indexing
+    // iA = j*im + i, iE = ihc*nA + iA (as in a ModelE grid file)
+    AbbrGrid agridA;
+    agridA.name = "A";
+    agridA.indexing = Indexing({"i", "j"}, {0,0}, {args.im, args.jm}, {1,0});
+    agridA.dim.set_sparse_extent(nA);
+    std::vector<double> hcdefs;
+    for (int ihc=0; ihc<args.nhc; ++ihc) hcdefs.push_back(ihc * 200.);
+    std::unique_ptr<GCMRegridder_Standard> gcmA(new GCMRegridder_Standard());
+    gcmA->init(std::move(agridA), std::move(hcdefs),
+        Indexing({"A", "HC"}, {0,0}, {nA, (long)args.nhc}, {1,0}), false);
+    gcm_regridder.reset(gcmA.release());
+
+    // ----------- Latitude-band decomposition
+    std::vector<ibmisc::Domain> blocks;
+    for (int r=0; r<world.size(); ++r) {
+        int const j0 = (long)args.jm * r / world.size();
+        int const j1 = (long)args.jm * (r+1) / world.size();
+        blocks.push_back(ibmisc::Domain({0,j0}, {args.im,j1}));
+    }
+    domainA = blocks[world.rank()];
+    domainA_global = ibmisc::Domain({0,0}, {args.im, args.jm});
+    std::vector<int> rank_of_iA;
+    if (am_i_root()) {
+        rank_of_iA = rank_of_iA_from_blocks(blocks, domainA_global);
+        domain_blocks = std::move(blocks);
+    }
+    set_rank_of_iA(std::move(rank_of_iA));
+
+    // ----------- Variables, as registered by gcmce_add_gcm_xxx()
+    // Arrays are C-order (ihc,j,i) / (j,i), over this rank's block only
+    static double const xnan = std::numeric_limits<double>::quiet_NaN();
+    blitz::Range const rhc(0, args.nhc-1);
+    blitz::Range const rj(domainA[1].begin, domainA[1].end-1);
+    blitz::Range const ri(domainA[0].begin, domainA[0].end-1);
+
+    for (int ivar=0; ivar<args.nvarE; ++ivar) {
+        gcm_outputsE.add("oE" + std::to_string(ivar), xnan, "1", "1", 1., 0., 0, "");
+        gcm_ovalsE.push_back(std::unique_ptr<blitz::Array<double,3>>(
+            new blitz::Array<double,3>(rhc, rj, ri)));
+        *gcm_ovalsE.back() = 0;
+    }
+
+    std::array<int, (int)IndexAE::COUNT> nvar {args.nvarA, args.nvarE, args.nvar_topo, args.nvar_topo};
+    for (int index_ae=0; index_ae<(int)IndexAE::COUNT; ++index_ae) {
+        for (int ivar=0; ivar<nvar[index_ae]; ++ivar) {
+            bool const underice = (index_ae == (int)IndexAE::ETOPO && ivar == nvar[index_ae]-1);
+            std::string const name(underice ? std::string("underice_d")
+                : "i" + std::to_string(index_ae) + "_" + std::to_string(ivar));
+            gcm_inputs[index_ae].add(name, xnan, "1", "1", 1., 0., 0, "");
+
+            if (gcm_inputs_grid[index_ae] == 'A') {
+                gcm_ivalssA[index_ae].push_back(std::unique_ptr<blitz::Array<double,2>>(
+                    new blitz::Array<double,2>(rj, ri)));
+                *gcm_ivalssA[index_ae].back() = 0;
+            } else {
+                gcm_ivalssE[index_ae].push_back(std::unique_ptr<blitz::Array<double,3>>(
+                    new blitz::Array<double,3>(rhc, rj, ri)));
+                *gcm_ivalssE[index_ae].back() = 0;
+            }
+        }
+    }
+
+    // Mark the ice-covered cells, as the TOPO from model start would
+    auto &underice(*gcm_ivalssE[(int)IndexAE::ETOPO].back());
+    for (int j=domainA[1].begin; j < domainA[1].end; ++j) {
+    for (int i=domainA[0].begin; i < domainA[0].end; ++i) {
+        if (is_ice(args, (long)j*args.im + i)) underice(rhc, j, i) = UI_LOCALICE;
+    }}
+}
+
+GCMInput BenchCoupler::couple(
+    double time_s,
+    VectorMultivec const &gcm_ovalsE_s,
+    bool run_ice)
+{
+    if (!am_i_root()) return GCMInput({0,0,0,0});
+
+    long const nA = (long)args.im * args.jm;
+    std::vector<int> nvar;
+    for (VarSet const &vs : gcm_inputs) nvar.push_back(vs.size());
+    GCMInput out(nvar);
+
+    std::vector<double> val(std::max(args.nvarA, std::max(args.nvarE, args.nvar_topo)));
+    for (long iA=0; iA<nA; ++iA) {
+        if (!is_ice(args, iA)) continue;
+
+        for (int i=0; i<args.nvarA; ++i) val[i] = iA + i;
+        out.gcm_ivalss_s[(int)IndexAE::A].add(iA, &val[0], 1.0);
+        for (int i=0; i<args.nvar_topo; ++i) val[i] = iA - i;
+        out.gcm_ivalss_s[(int)IndexAE::ATOPO].add(iA, &val[0], 1.0);
+
+        for (int ihc=0; ihc<args.nhc; ++ihc) {
+            long const iE = ihc*nA + iA;
+            for (int i=0; i<args.nvarE; ++i) val[i] = iE + i;
+            out.gcm_ivalss_s[(int)IndexAE::E].add(iE, &val[0], 1.0);
+            for (int i=0; i<args.nvar_topo; ++i) val[i] = iE - i;
+            val[args.nvar_topo-1] = UI_LOCALICE;    // underice_d: stay ice-covered
+            out.gcm_ivalss_s[(int)IndexAE::ETOPO].add(iE, &val[0], 1.0);
+        }
+    }
+
+    // E1vE0c: each elevation class gets a little from its neighbors
+    if (run_ice) {
+        int const nE = nA*args.nhc;
+        out.E1vE0c.set_shape({nE, nE});
+        for (int iA=0; iA<nA; ++iA) {
+            if (!is_ice(args, iA)) continue;
+            for (int ihc=0; ihc<args.nhc; ++ihc) {
+                int const iE = ihc*nA + iA;
+                if (ihc > 0) out.E1vE0c.add({iE, iE-nA}, .1);
+                if (ihc < args.nhc-1) out.E1vE0c.add({iE, iE+nA}, .1);
+                out.E1vE0c.add({iE, iE}, -.2);
+            }
+        }
+    }
+
+    // Touch the inputs, as couple() would
+    double sum = 0;
+    for (double v : gcm_ovalsE_s.vals) sum += v;
+    if (sum != sum) (*icebin_error)(-1, "NaN in gcm_ovalsE");
+
+    // Measure what gcmce_couple_native() is about to scatter.
+    // compact_for_scatter() updates E1vE0c_sent; restore it so the
+    // real call sees the same state.
+    double const t1 = MPI_Wtime();
+    std::vector<GCMInput> every_outs(split_by_domain(out, *domains, *domains));
+    auto const E1vE0c_sent0(E1vE0c_sent);
+    compact_for_scatter(this, every_outs, run_ice);
+    E1vE0c_sent = E1vE0c_sent0;
+    scatter_bytes = 0;
+    for (auto const &eout : every_outs) scatter_bytes += wire_bytes(gcm_params.world, eout);
+    measure_time += MPI_Wtime() - t1;
+
+    return out;
+}
+
+int main(int argc, char **argv)
+{
+    boost::mpi::environment env(argc, argv);
+    boost::mpi::communicator world;
+    int const root = 0;
+    bool const am_root = (world.rank() == root);
+
+    ParseArgs args(argc, argv);
+    if (args.nvar_topo < 1) (*icebin_error)(-1,
+        "--nvar-topo must be at least 1 (for underice_d)");
+
+    BenchCoupler self(args, world);
+    ibmisc::Domain const &domainA(self.domainA);
+
+    int *E1vE0c_indices;
+    double *E1vE0c_values;
+    int E1vE0c_nele;
+
+    // Initialization call, as from gcmce_model_start()
+    gcmce_couple_native(&self, 0, false,
+        &E1vE0c_indices, &E1vE0c_values, &E1vE0c_nele);
+    std::fill(self.phase_time.begin(), self.phase_time.end(), 0.);    // Not timed
+
+    std::vector<double> times(NPHASE, 0.);
+    size_t bytes_sent = 0;    // This rank's gather message + (root) scatter messages
+
+    for (int step=0; step<args.steps; ++step) {
+        // ---------- This step's GCM outputs
+        for (int ivar=0; ivar<args.nvarE; ++ivar) {
+            auto &ovalsE(*self.gcm_ovalsE[ivar]);
+            for (int ihc=0; ihc<args.nhc; ++ihc) {
+            for (int j=domainA[1].begin; j < domainA[1].end; ++j) {
+            for (int i=domainA[0].begin; i < domainA[0].end; ++i) {
+                ovalsE(ihc,j,i) = step + ivar + ihc;
+            }}}
+        }
+
+        double const measured0 = self.measured_time;
+        double const t0 = MPI_Wtime();
+        gcmce_couple_native(&self, step+1, true,
+            &E1vE0c_indices, &E1vE0c_values, &E1vE0c_nele);
+        times[TOTAL] += MPI_Wtime() - t0 - (self.measured_time - measured0);
+        bytes_sent += self.gather_bytes;
+        if (am_root) bytes_sent += self.scatter_bytes;
+    }
+
+    for (int p=0; p<TOTAL; ++p) times[p] = self.phase_time[p];
+
+    // ---------- Report
+    std::vector<std::vector<double>> every_times;
+    std::vector<size_t> every_bytes;
+    boost::mpi::gather(world, times, every_times, root);
+    boost::mpi::gather(world, bytes_sent, every_bytes, root);
+
+    if (am_root) {
+        printf("couple_bench: %d ranks, A=%dx%d, nhc=%d, %d steps%s\n",
+            world.size(), args.im, args.jm, args.nhc, args.steps,
+            args.scatter_float ? ", float scatter" : "");
+        printf("%-10s %12s %12s\n", "phase", "root (s)", "max rank (s)");
+        for (int p=0; p<NPHASE; ++p) {
+            double tmax = 0;
+            for (auto const &t : every_times) tmax = std::max(tmax, t[p]);
+            printf("%-10s %12.6f %12.6f\n", phase_names[p],
+                every_times[root][p] / args.steps, tmax / args.steps);
+        }
+        printf("\n%-6s %16s\n", "rank", "bytes/step");
+        for (int r=0; r<world.size(); ++r) {
+            printf("%-6d %16ld\n", r, (long)(every_bytes[r] / args.steps));
+        }
+    }
+
+    return 0;
+}
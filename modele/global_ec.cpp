@@ -294,6 +294,59 @@ ParseArgs::ParseArgs(int argc, char **argv)
 
 // ==========================================================
 
+/** Reads fgiceI and elevI one band of I-grid rows (a hyperslab) at a
+time, so memory use is set by the band, not by the global I grid.
+The arrays are indexed by global (jI, iI), for jI0 <= jI < jI1. */
+class IceBandReader {
+    NcIO ncio;
+    NcVar fgiceI_v, elevI_v;
+    int const im;
+public:
+    int jI0 = 0, jI1 = 0;
+    blitz::Array<int16_t,2> fgiceI;    // 0 or 1
+    blitz::Array<int16_t,2> elevI;
+
+    IceBandReader(std::string const &fname, ParseArgs const &args)
+        : ncio(fname, 'r'),
+        fgiceI_v(ncio.nc->getVar(args.fgiceI_vname)),
+        elevI_v(ncio.nc->getVar(args.elevI_vname)),
+        im(args.hspecI.im)
+    {
+        for (NcVar const *v : {&fgiceI_v, &elevI_v}) {
+            if (v->getDimCount() != 2
+                || v->getDim(0).getSize() != (size_t)args.hspecI.jm
+                || v->getDim(1).getSize() != (size_t)args.hspecI.im)
+            {
+                (*icebin_error)(-1, "%s:%s must have shape (%d, %d)",
+                    fname.c_str(), v->getName().c_str(),
+                    args.hspecI.jm, args.hspecI.im);
+            }
+        }
+    }
+
+    /** Reads rows [_jI0, _jI1) */
+    void read(int _jI0, int _jI1)
+    {
+        if (_jI0 == jI0 && _jI1 == jI1) return;
+        jI0 = _jI0;
+        jI1 = _jI1;
+
+        blitz::Range const rj(jI0, jI1-1), ri(0, im-1);
+        fgiceI.reference(blitz::Array<int16_t,2>(rj, ri));
+        elevI.reference(blitz::Array<int16_t,2>(rj, ri));
+
+        std::vector<size_t> const start {(size_t)jI0, 0};
+        std::vector<size_t> const count {(size_t)(jI1-jI0), (size_t)im};
+        fgiceI_v.getVar(start, count, fgiceI.data());
+        elevI_v.getVar(start, count, elevI.data());
+    }
+};
+
+/** elevmaskI for one chunk only spans that chunk's band of the I grid:
+its indices run from the band's first (global, 1-D) I index. */
+static bool in_band(blitz::Array<double,1> const &elevmaskI, long iI)
+    { return iI >= elevmaskI.lbound(0) && iI <= elevmaskI.ubound(0); }
+
 class ExchAccum {
     ExchangeGrid &exgrid;
     blitz::Array<double,1> const &elevmaskI;
@@ -311,7 +364,7 @@ public:
     {
         auto const iO(index[0]);
         auto const iI(index[1]);
-        if (!std::isnan(elevmaskI(iI))) {
+        if (in_band(elevmaskI, iI) && !std::isnan(elevmaskI(iI))) {
             // Save as sparse indexing, as required by IceRegridder::init()
             exgrid.add(index, area);
 int sz = exgrid.dense_extent();
@@ -339,7 +392,7 @@ public:
     ElevMaskClip(blitz::Array<double,1> const &_elevmaskI) : elevmaskI(_elevmaskI) {}
 
     bool operator()(int ix) const
-        { return !std::isnan(elevmaskI(ix)); }
+        { return in_band(elevmaskI, ix) && !std::isnan(elevmaskI(ix)); }
 };
 
 
@@ -383,7 +436,7 @@ linear::Weighted_Eigen make_I2vX(
 std::unique_ptr<GCMRegridder_Standard> new_gcmA_standard(
     HntrSpec const &hspecA,
     std::string const &grid_name,
-    ParseArgs const &args, blitz::Array<double,2> const &elevmaskI)
+    ParseArgs const &args, blitz::Array<double,1> const &elevmaskI)
 {
     ExchangeGrid aexgrid;    // Put our answer in here
 
@@ -397,7 +450,7 @@ std::unique_ptr<GCMRegridder_Standard> new_gcmA_standard(
     // Compute overlaps for cells with ice
     SparseSet<long,int> _dimA;    // Only include A grid cells with ice
     SparseSet<long,int> _dimI;    // Only include I grid cells with ice
-    hntr.overlap(ExchAccum(aexgrid, reshape1(elevmaskI), _dimA, _dimI), args.eq_rad);
+    hntr.overlap(ExchAccum(aexgrid, elevmaskI, _dimA, _dimI), args.eq_rad);
 
     // -------------------------------------------------------------
     printf("---- Creating gcmA for %s\n", grid_name.c_str());
@@ -463,7 +516,7 @@ void check_negative(linear::Weighted_Eigen const &mat, std::string const &name)
 }
 // -------------------------------------------------
 std::unique_ptr<GCMRegridder> new_gcmA_mismatched(
-    FileLocator const &files, ParseArgs const &args, blitz::Array<double,2> const &elevmaskI)
+    FileLocator const &files, ParseArgs const &args, blitz::Array<double,1> const &elevmaskI)
 {
     auto const &hspecO(args.hspecO);
     auto const &hspecI(args.hspecI);
@@ -510,11 +563,11 @@ std::unique_ptr<GCMRegridder> new_gcmA_mismatched(
 @param matrix_names Names of matrices to generate (or all, if it's empty)
 */
 void global_ec_section(GCMRegridder &gcmA, ParseArgs &args,
-    blitz::Array<double,2> const &elevmaskI, HntrSpec &hspecI2,
+    blitz::Array<double,1> const &elevmaskI, HntrSpec &hspecI2,
     std::vector<std::string> const &matrix_names)
 {
 
-    std::unique_ptr<RegridMatrices_Dynamic> rm(gcmA.regrid_matrices(0, reshape1(elevmaskI)));
+    std::unique_ptr<RegridMatrices_Dynamic> rm(gcmA.regrid_matrices(0, elevmaskI));
 
     // ---------- Generate and store the matrices
     // Use the mismatched regridder to create desired matrices and save to file
@@ -533,7 +586,7 @@ void global_ec_section(GCMRegridder &gcmA, ParseArgs &args,
     HntrSpec hspecA(cast_GridSpec_LonLat(
         *gcmA.agridA->spec).hntr);
     HntrSpec hspecI(cast_GridSpec_LonLat(
-        *gcmA.ice_regridders()[0]->agridI.spec).hntr);
+        *gcmA.ice_regridders()[0]->agridI().spec).hntr);
 
 
     {NcIO ncio(ofname, 'w', "nc4", nocompress);
@@ -543,7 +596,7 @@ void global_ec_section(GCMRegridder &gcmA, ParseArgs &args,
         meta.hspecA = hspecA;
         meta.hspecI = hspecI;
         meta.hspecI2 = hspecI2;
-        meta.indexingI = gcmA.ice_regridders()[0]->agridI.indexing;
+        meta.indexingI = gcmA.ice_regridders()[0]->agridI().indexing;
         {HntrGrid hgridI2(hspecI2);
             meta.indexingI2 = hgridI2.indexing;
         }
@@ -590,7 +643,7 @@ void global_ec_section(GCMRegridder &gcmA, ParseArgs &args,
         ncio.flush();
 
         // Save smaller / more wieldly display version of the matrix
-        auto mat2(make_I2vX(*mat, args, reshape1(elevmaskI), dimI2, dimI, dimE, params));
+        auto mat2(make_I2vX(*mat, args, elevmaskI, dimI2, dimI, dimE, params));
         mat.release();
         mat2.ncio(ncio, "I2vE", {"dimI2", "dimE"});
         ncio.flush();
@@ -606,7 +659,7 @@ void global_ec_section(GCMRegridder &gcmA, ParseArgs &args,
         ncio.flush();
 
         // Save smaller / more wieldly display version of the matrix
-        auto mat2(make_I2vX(*mat, args, reshape1(elevmaskI), dimI2, dimI, dimA, params));
+        auto mat2(make_I2vX(*mat, args, elevmaskI, dimI2, dimI, dimA, params));
         mat.release();
         mat2.ncio(ncio, "I2v"+Achar, {"dimI2", "dim"+Achar});
         ncio.flush();
@@ -661,7 +714,7 @@ void global_ec_section(GCMRegridder &gcmA, ParseArgs &args,
     printf("Done!\n");
 }
 
-void global_ec_section(FileLocator const &files, ParseArgs &args, blitz::Array<double,2> const &elevmaskI)
+void global_ec_section(FileLocator const &files, ParseArgs &args, blitz::Array<double,1> const &elevmaskI)
 {
     switch(args.gcm_grid_option.index()) {
         case GCMGridOption::mismatched : {
@@ -759,58 +812,23 @@ int main(int argc, char **argv)
             hspecI.im, hspecI.jm, hspecO.im, hspecO.jm);
     }
 
-    // -----------------------------------------
-    blitz::Array<double,2> fgiceO(hspecO.jm, hspecO.im);
-    {
-        // Allocate arrays
-        blitz::Array<int16_t,2> fgiceI(hspecI.jm, hspecI.im);    // 0 or 1
-        blitz::Array<int16_t,2> elevI(hspecI.jm, hspecI.im);
-
-        // Read in ice extent and elevation
-        {auto fname(files.locate(args.nc_fname));
-            NcIO ncio(fname, 'r');
-            ncio_blitz(ncio, fgiceI, args.fgiceI_vname, "short", {});
-            ncio_blitz(ncio, elevI, args.elevI_vname, "short", {});
-        }
-        // -----------------------------------------
-
-        // Generate fgiceO
-        auto wtI(const_array(fgiceI.shape(), 1.0));
-        Hntr hntrOvI(17.17, args.hspecO, args.hspecI);
-        hntrOvI.regrid(wtI, fgiceI, fgiceO);
-
-#if 0
-        // Generate elevA
-        // (This is a shortcut, compared to creating a GCMRegridder for A).
-        HntrSpec const hspecA(make_hntrA(args.hspecO));
-        blitz::Array<double,2> elevA(
-        Hntr hntrAvI(17.17, hspecA, args.hspecI);
-        hntrAvI.regrid(fgiceI, elevI, elevA);
-#endif
-
-    }
-
-
-    // Allocate arrays
-    blitz::Array<int16_t,2> fgiceI(hspecI.jm, hspecI.im);    // 0 or 1
-    blitz::Array<int16_t,2> elevI(hspecI.jm, hspecI.im);
-
-    // Read in ice extent and elevation
-    {auto fname(files.locate(args.nc_fname));
-        NcIO ncio(fname, 'r');
-        ncio_blitz(ncio, fgiceI, args.fgiceI_vname, "short", {});
-        ncio_blitz(ncio, elevI, args.elevI_vname, "short", {});
-    }
+    // fgiceI and elevI are read one band of rows at a time, so memory
+    // use does not grow with the global I grid.  Bands are whole O-grid
+    // rows, since chunks are ranges of O grid cells.
+    IceBandReader band(files.locate(args.nc_fname), args);
 
     // Get max. and min. elevation for ice
     std::array<int16_t,2> elevI_range {10000,-10000};
-    for (int j=0; j<hspecI.jm; ++j) {
-    for (int i=0; i<hspecI.im; ++i) {
-        if (fgiceI(j,i)) {
-            elevI_range[0] = std::min(elevI_range[0], elevI(j,i));
-            elevI_range[1] = std::max(elevI_range[1], elevI(j,i));
-        }
-    }}
+    for (int jO=0; jO<hspecO.jm; ++jO) {
+        band.read(jO*mult_j, (jO+1)*mult_j);
+        for (int j=band.jI0; j<band.jI1; ++j) {
+        for (int i=0; i<hspecI.im; ++i) {
+            if (band.fgiceI(j,i)) {
+                elevI_range[0] = std::min(elevI_range[0], band.elevI(j,i));
+                elevI_range[1] = std::max(elevI_range[1], band.elevI(j,i));
+            }
+        }}
+    }
     // C++11 standard rounds toward 0
     args.ec_range[0] = args.ec_skip*std::floor((double)elevI_range[0] / args.ec_skip);
     args.ec_range[1] = args.ec_skip*std::ceil((double)elevI_range[1] / args.ec_skip);
@@ -818,44 +836,48 @@ int main(int argc, char **argv)
     if (args.run_chunk) {
         // ============== Run just one chunk
 
-        // Choose the ice to process on this chunk
-        blitz::Array<double,2> elevmaskI(hspecI.jm, hspecI.im);
-        elevmaskI = NaN;
-
         // Upper bound
         int const jO1 = args.chunk_range[1][0];
         int const iO1 = args.chunk_range[1][1];
         int const ijO1 = jO1 * hspecO.im + iO1;
 
         // Set up elevmaskI for the specified range of O grid cells
-        int iO = args.chunk_range[0][1];    // Where we start scanning in fgiceO
+        int iO = args.chunk_range[0][1];    // Where we start scanning in the O grid
         int jO = args.chunk_range[0][0];
         int ijO = jO * hspecO.im + iO;
-//printf("elevmaskI: iO=%d, jO=%d, ijO=%d\n", iO, jO, ijO);
+
+        // Only read (and allocate elevmaskI for) the rows of I this chunk covers
+        int const jI0 = jO * mult_j;
+        int const jI1 = std::max(jI0+1,
+            std::min(hspecO.jm, jO1 + (iO1 > 0 ? 1 : 0)) * mult_j);
+        band.read(jI0, jI1);
+
+        // Choose the ice to process on this chunk
+        // (indexed by global 1-D I index; see in_band())
+        blitz::Array<double,1> elevmaskI(
+            blitz::Range(jI0*hspecI.im, jI1*hspecI.im - 1));
+        elevmaskI = NaN;
+
 printf("Range: [%d %d] - [%d %d]\n", jO, iO, jO1, iO1);
         printf("BEGIN O(%d, %d)\n", jO, iO);
         for (; ; ++jO) {
             for (; iO < hspecO.im; ++iO, ++ijO) {
                 if (ijO >= ijO1) goto endscan;    // Double break
 
-                if (fgiceO(jO, iO) != 0) {
-//printf("fgiceO(%d,%d)\n", jO, iO);
-                    // Add these I grid cells to elevmaskI
-                    for (int jI=jO*mult_j; jI<(jO+1)*mult_j; ++jI) {
-                    for (int iI=iO*mult_i; iI<(iO+1)*mult_i; ++iI) {
-//printf("elevmaskI(%d,%d) = %d %d\n", jI, iI, fgiceI(jI,iI), elevI(jI,iI));
-                        if (fgiceI(jI,iI)) {
-                            elevmaskI(jI,iI) = elevI(jI,iI);
-                        }
-                    }}
-                }
+                // Add these I grid cells to elevmaskI
+                for (int jI=jO*mult_j; jI<(jO+1)*mult_j; ++jI) {
+                for (int iI=iO*mult_i; iI<(iO+1)*mult_i; ++iI) {
+                    if (band.fgiceI(jI,iI)) {
+                        elevmaskI(jI*hspecI.im + iI) = band.elevI(jI,iI);
+                    }
+                }}
             }
             iO = 0;
         }
     endscan: ;
         printf("END O(%d, %d)\n", jO, iO);
-        fgiceI.free();
-        elevI.free();
+        band.fgiceI.free();
+        band.elevI.free();
 
         // Process the chunk!
         global_ec_section(files, args, elevmaskI);
@@ -865,7 +887,7 @@ printf("Range: [%d %d] - [%d %d]\n", jO, iO, jO1, iO1);
         std::vector<std::array<int,5>> chunks;
 
         // Loop over chunks
-        int iO = 0;    // Where we start scanning in fgiceO
+        int iO = 0;    // Where we start scanning in the O grid
         int jO = 0;
         for (int chunkno=0; (jO < hspecO.jm) && (iO < hspecO.im); ++chunkno) {
             int nice=0;
@@ -874,16 +896,14 @@ printf("Range: [%d %d] - [%d %d]\n", jO, iO, jO1, iO1);
 
             // Choose the ice to process on this chunk
             for (; jO < hspecO.jm; ++jO) {
+                band.read(jO*mult_j, (jO+1)*mult_j);
                 for (; iO < hspecO.im; ++iO) {
-                    if (fgiceO(jO, iO) != 0) {
-
-                        // Add these I grid cells to elevmaskI
-                        for (int jI=jO*mult_j; jI<(jO+1)*mult_j; ++jI) {
-                        for (int iI=iO*mult_i; iI<(iO+1)*mult_i; ++iI) {
-                            if (fgiceI(jI,iI)) ++nice;
-                        }}
-                        if (nice >= chunk_size) goto endscan2;    // double break
-                    }
+                    // Count these I grid cells
+                    for (int jI=jO*mult_j; jI<(jO+1)*mult_j; ++jI) {
+                    for (int iI=iO*mult_i; iI<(iO+1)*mult_i; ++iI) {
+                        if (band.fgiceI(jI,iI)) ++nice;
+                    }}
+                    if (nice >= chunk_size) goto endscan2;    // double break
                 }
                 iO = 0;
             }
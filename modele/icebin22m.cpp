@@ -18,6 +18,9 @@ namespace modele {
 
 static double const NaN = std::numeric_limits<double>::quiet_NaN();
 
+/** Builds an A/I regridder from a grid file and overlap files.  Not
+converted to load_regridder_bundle(): the bundle holds the ocean-grid
+regridder used for TOPO generation, not this one. */
 std::unique_ptr<GCMRegridder_Standard> load_AI_regridder(
     std::string const &agridA_fname,
     std::string const &agridA_vname,
@@ -19,6 +19,7 @@
 #include <icebin/modele/global_ec.hpp>
 #include <icebin/modele/topo.hpp>
 #include <icebin/modele/merge_topo.hpp>
+#include <icebin/modele/regridder_bundle.hpp>
 
 using namespace netCDF;
 using namespace ibmisc;
@@ -68,6 +69,12 @@ struct ParseArgs {
     state files written by PISM are read. */
     std::vector<std::string> elevmask_xfnames;
 
+    /** Name of the regridder bundle file: the grids of gcmO_fname as
+    memory-mappable arrays, created if it does not exist or is out of
+    date.  Other topo tools run in the same workflow may map it instead
+    of re-parsing gcmO_fname.  Empty if no bundle is to be used. */
+    std::string bundle_fname;
+
     /** Should elevation classes between global and local ice be merged?
     This is desired when running without two-way coupling. */
     bool squash_ec;
@@ -103,6 +110,10 @@ ParseArgs::ParseArgs(int argc, char **argv)
             "File containing the GCMRegridder representing all ice sheets to be merged in (ocean grid)",
             false, "gcmO.nc", "GCMRegridder description", cmd);
 
+        TCLAP::ValueArg<std::string> bundle_a("b", "bundle",
+            "Regridder bundle file: mappable copy of --gcmO's grids (created if needed)",
+            false, "", "regridder bundle file", cmd);
+
         TCLAP::ValueArg<bool> squash_ec_a("s", "squash_ec",
             "Merge elevation classes between global and local ice?",
             false, true, "bool", cmd);
@@ -128,6 +139,7 @@ ParseArgs::ParseArgs(int argc, char **argv)
         topoo_ng_fname = topoo_ng_a.getValue();
         global_ecO_ng_fname = global_ecO_ng_a.getValue();
         gcmO_fname = gcmO_ng_a.getValue();
+        bundle_fname = bundle_a.getValue();
         squash_ec = squash_ec_a.getValue();
         elevmask_xfnames = elevmask_a.getValue();
         topoo_merged_fname = topoo_merged_a.getValue();
@@ -148,14 +160,15 @@ int main(int argc, char **argv)
 
     // ================================== Read Input Files
 
-    // Read metadata and global EOpvAOp matrix (from output of global_ec.cpp)
-    global_ec::Metadata metaO;
-    ibmisc::ZArray<int,double,2> EOpvAOp_ng;
-    {NcIO ncio(args.global_ecO_ng_fname, 'r');
-        metaO.ncio(ncio);
-        EOpvAOp_ng.ncio(ncio, "EvO.M");
-    }
-    HntrSpec &hspecO(metaO.hspecA);
+    // Read metadata, global EOpvAOp matrix (from output of global_ec.cpp)
+    // and the GCMRegridder; via the regridder bundle, if one is given.
+    std::shared_ptr<RegridderBundle const> bundle(load_regridder_bundle(
+        args.global_ecO_ng_fname, args.gcmO_fname, args.bundle_fname));
+    global_ec::Metadata const &metaO(bundle->metaO);
+    ibmisc::ZArray<int,double,2> const &EOpvAOp_ng(bundle->EOpvAOp_base);
+    GCMRegridder_Standard const &gcmO(*bundle->gcmO);
+
+    HntrSpec const &hspecO(metaO.hspecA);
     // HntrSpec hspecA(make_hntrA(hspecO));
     // Indexing &indexingHCO(metaO.indexingHC);
     // Indexing indexingHCA({"A", "HC"}, {0,0}, {hspecA.size(), indexingHCO[1].extent}, {1,0});
@@ -190,12 +203,6 @@ int main(int argc, char **argv)
     // This is created in the merge.
     blitz::Array<int16_t,2> mergemaskO(hspecO.jm,hspecO.im);
 
-    // Read the GCMRegridder
-    GCMRegridder_Standard gcmO;
-    {NcIO gcmO_nc(args.gcmO_fname, 'r');
-        gcmO.ncio(gcmO_nc, "m");
-    }
-
     // Read per-ice sheet elevmasks (for land+ice and ice only)
     std::vector<blitz::Array<double,1>> emI_lands, emI_ices;
     for (auto const &xfname : args.elevmask_xfnames) {
@@ -246,10 +253,11 @@ int main(int argc, char **argv)
     ZArray<int,double,2> EOpvAOp_c({eam.dimEOp.sparse_extent(), dimAOp.sparse_extent()});
     std::vector<double> lonc(metaO.hspecA.lonc());
     std::vector<double> latc(metaO.hspecA.latc());
+    HntrSpec hspecO_out(metaO.hspecA);    // ncio() needs non-const; bundle is shared
     {NcIO ncio(args.topoo_merged_fname, 'w');
 
         // Write Ocean grid metadata
-        metaO.hspecA.ncio(ncio, "hspecO");    // Actually ocean grid
+        hspecO_out.ncio(ncio, "hspecO");    // Actually ocean grid
 
         ncio_vector(ncio, lonc, false, "lon", "double",
             get_or_add_dims(ncio, {"im"}, {(long)lonc.size()}));
@@ -0,0 +1,375 @@
+/*
+Applies IceBin regrid matrices to whole time series of NetCDF variables.
+
+Each needed matrix is built once; time slices are then streamed
+through it in batches, so memory use is bounded regardless of the
+length of the series.  Writing of the previous batch, then reading of
+the next one, overlap with the regridding of the current batch.  They
+are done one after the other by a single I/O task, since NetCDF is not
+thread-safe; the main thread makes no NetCDF calls meanwhile.
+
+INPUT:
+    * Regridder file (written by GCMRegridder_Standard::ncio())
+    * elevmask for one ice sheet (eg: pism:state.nc)
+    * NetCDF file containing the variables to regrid.  Each variable
+      must have the time (record) dimension first; remaining
+      dimensions must flatten to the input grid of its matrix.
+
+OUTPUT:
+    NetCDF file with one regridded variable per input variable, with
+    dimensions (time, <output grid dimensions>).
+
+Example:
+    regrid_series -r gcmO.nc -e pism:state.nc -s greenland \
+        -v IvE:SMB,IvE:TG2 -i modele_out.nc -o pism_in.nc
+*/
+
+#include <string>
+#include <iostream>
+#include <future>
+#include <map>
+
+#include <tclap/CmdLine.h>
+
+#include <ibmisc/netcdf.hpp>
+#include <ibmisc/blitz.hpp>
+#include <ibmisc/string.hpp>
+#include <ibmisc/linear/eigen.hpp>
+#include <everytrace.h>
+
+#include <icebin/GCMRegridder.hpp>
+#include <icebin/ElevMask.hpp>
+
+using namespace std;
+using namespace ibmisc;
+using namespace icebin;
+using namespace netCDF;
+
+static double const NaN = std::numeric_limits<double>::quiet_NaN();
+
+// ==========================================================
+struct ParseArgs {
+    std::string regridder_fname;
+    std::string regridder_vname;
+    std::string elevmask_spec;
+    bool ice_only;              // Use elevmask for ice only (vs. ice + bare land)
+    std::string sheet_name;
+
+    std::string ifname;
+    std::string ofname;
+
+    // (matrix name, variable name)
+    std::vector<std::tuple<std::string, std::string>> vars;
+
+    RegridParams params;
+    int nbatch;                 // Number of time slices to process at once
+
+    ParseArgs(int argc, char **argv);
+};
+
+ParseArgs::ParseArgs(int argc, char **argv)
+{
+    // Wrap everything in a try block.  Do this every time,
+    // because exceptions will be thrown for problems.
+    try {
+        TCLAP::CmdLine cmd("Applies IceBin regrid matrices to time series of NetCDF variables", ' ', "<no-version>");
+
+        TCLAP::ValueArg<std::string> regridder_a("r", "regridder",
+            "Regridder file, written by GCMRegridder::ncio()",
+            true, "gcmO.nc", "regridder file", cmd);
+
+        TCLAP::ValueArg<std::string> regridder_vname_a("", "regridder-vname",
+            "Name of the regridder inside the regridder file",
+            false, "m", "regridder var name", cmd);
+
+        TCLAP::ValueArg<std::string> elevmask_a("e", "elevmask",
+            "Elevation mask for the ice sheet, as <type>:<fname> (eg: pism:state.nc)",
+            true, "pism:state.nc", "elevmask spec", cmd);
+
+        TCLAP::SwitchArg ice_only_a("", "ice-only",
+            "Regrid only to ice-covered cells (default: ice + bare land)",
+            cmd, false);
+
+        TCLAP::ValueArg<std::string> sheet_a("s", "sheet",
+            "Name of ice sheet to regrid with",
+            false, "greenland", "ice sheet name", cmd);
+
+        TCLAP::ValueArg<std::string> vars_a("v", "vars",
+            "Comma-separated <matrix>:<variable> pairs, no spaces (eg: IvE:SMB,IvA:TS)",
+            true, "IvE:SMB", "variables", cmd);
+
+        TCLAP::ValueArg<std::string> ifname_a("i", "input",
+            "Input NetCDF file",
+            true, "in.nc", "input file", cmd);
+
+        TCLAP::ValueArg<std::string> ofname_a("o", "output",
+            "Output NetCDF file",
+            true, "out.nc", "output file", cmd);
+
+        TCLAP::SwitchArg noscale_a("", "no-scale",
+            "Produce unscaled matrices ([kg] instead of [kg m-2])",
+            cmd, false);
+
+        TCLAP::SwitchArg nocorrectA_a("", "no-correctA",
+            "Do not correct for projection error on A and E grids",
+            cmd, false);
+
+        TCLAP::ValueArg<std::string> sigma_a("g", "sigma",
+            "Smoothing distances: x,y,z",
+            false, "0,0,0", "smoothing distances", cmd);
+
+        TCLAP::ValueArg<int> nbatch_a("b", "batch",
+            "Number of time slices to read / regrid / write at once",
+            false, 12, "batch size", cmd);
+
+        // Parse the argv array.
+        cmd.parse( argc, argv );
+
+        regridder_fname = regridder_a.getValue();
+        regridder_vname = regridder_vname_a.getValue();
+        elevmask_spec = elevmask_a.getValue();
+        ice_only = ice_only_a.getValue();
+        sheet_name = sheet_a.getValue();
+        ifname = ifname_a.getValue();
+        ofname = ofname_a.getValue();
+        nbatch = std::max(1, nbatch_a.getValue());
+
+        for (auto const &svar : split<std::string>(vars_a.getValue(), ",")) {
+            int colon = svar.find(':');
+            if (colon < 0) (*icebin_error)(-1,
+                "Variable '%s' must be in the format matrix:variable", svar.c_str());
+            vars.push_back(std::make_tuple(svar.substr(0, colon), svar.substr(colon+1)));
+        }
+
+        auto _sigma(split<double>(sigma_a.getValue(), ","));
+        if (_sigma.size() != 3) (*icebin_error)(-1,
+            "--sigma '%s' must have exactly three values", sigma_a.getValue().c_str());
+
+        params = RegridParams(!noscale_a.getValue(), !nocorrectA_a.getValue(),
+            {_sigma[0], _sigma[1], _sigma[2]});
+    } catch (TCLAP::ArgException &e) { // catch any exceptions
+        std::cerr << "error: " << e.error() << " for arg " << e.argId() << std::endl;
+        exit(1);
+    }
+}
+
+// ==========================================================
+/** A regrid matrix, along with the dimensions it was built with. */
+struct Matrix {
+    SparseSetT dimB, dimA;    // Output and input grids
+    std::unique_ptr<linear::Weighted_Eigen> M;
+    ibmisc::Indexing const *indexingB;    // Shape of the output grid
+};
+
+/** Builds (and caches) each matrix the first time it is requested. */
+class MatrixCache {
+    GCMRegridder const &gcm;
+    std::unique_ptr<RegridMatrices_Dynamic> rm;
+    RegridParams const params;
+    std::map<std::string, std::unique_ptr<Matrix>> cache;
+
+    ibmisc::Indexing const &indexing(char grid) const
+    {
+        switch(grid) {
+            case 'A' : return gcm.agridA->indexing;
+            case 'E' : return gcm.indexingE;
+            case 'I' : return rm->ice_regridder->agridI().indexing;
+        }
+        (*icebin_error)(-1, "Unknown grid '%c'", grid);
+    }
+
+public:
+    MatrixCache(GCMRegridder const &_gcm, int sheet_index,
+        blitz::Array<double,1> const &elevmaskI, RegridParams const &_params)
+    : gcm(_gcm), rm(gcm.regrid_matrices(sheet_index, elevmaskI, _params)), params(_params) {}
+
+    Matrix const &at(std::string const &spec_name)
+    {
+        auto ii(cache.find(spec_name));
+        if (ii != cache.end()) return *ii->second;
+
+        printf("---- Generating %s\n", spec_name.c_str());
+        std::unique_ptr<Matrix> mat(new Matrix);
+        mat->M = rm->matrix_d(spec_name, {&mat->dimB, &mat->dimA}, params);
+        mat->indexingB = &indexing(spec_name[0]);
+
+        Matrix const &ret(*mat);
+        cache.insert(std::make_pair(spec_name, std::move(mat)));
+        return ret;
+    }
+};
+
+// ==========================================================
+/** Buffers for one batch of time slices */
+struct Batch {
+    int t0 = 0;
+    int nt = 0;
+    blitz::Array<double,2> valA_s;    // (time, input sparse index)
+    blitz::Array<double,2> valB_s;    // (time, output sparse index)
+};
+
+void read_batch(NcVar &ncvar, Batch &batch, int t0, int nt)
+{
+    batch.t0 = t0;
+    batch.nt = nt;
+
+    std::vector<size_t> startp(ncvar.getDimCount(), 0);
+    std::vector<size_t> countp;
+    for (auto const &dim : ncvar.getDims()) countp.push_back(dim.getSize());
+    startp[0] = t0;
+    countp[0] = nt;
+    ncvar.getVar(startp, countp, batch.valA_s.data());
+}
+
+void write_batch(NcVar &ncvar, Batch const &batch)
+{
+    std::vector<size_t> startp(ncvar.getDimCount(), 0);
+    std::vector<size_t> countp;
+    for (auto const &dim : ncvar.getDims()) countp.push_back(dim.getSize());
+    startp[0] = batch.t0;
+    countp[0] = batch.nt;
+    ncvar.putVar(startp, countp, batch.valB_s.data());
+}
+
+/** Regrids one batch: sparse input --> dense --> M --> sparse output */
+void regrid_batch(Matrix const &mat, Batch &batch)
+{
+    int const nt = batch.nt;
+    auto const &dimA(mat.dimA);
+    auto const &dimB(mat.dimB);
+
+    blitz::Array<double,2> valA_d(nt, dimA.dense_extent());
+    for (int it=0; it<nt; ++it) {
+        for (int iA_d=0; iA_d<dimA.dense_extent(); ++iA_d) {
+            valA_d(it, iA_d) = batch.valA_s(it, dimA.to_sparse(iA_d));
+        }
+    }
+
+    TmpAlloc tmp;
+    auto valB_d(mat.M->apply(valA_d, NaN, false, tmp));
+
+    batch.valB_s = NaN;
+    for (int it=0; it<nt; ++it) {
+        for (int iB_d=0; iB_d<dimB.dense_extent(); ++iB_d) {
+            batch.valB_s(it, dimB.to_sparse(iB_d)) = valB_d(it, iB_d);
+        }
+    }
+}
+
+/** Streams all time slices of one variable through its matrix. */
+void regrid_var(Matrix const &mat, NcVar &ivar, NcVar &ovar, int ntime, int nbatch)
+{
+    long const nA = mat.dimA.sparse_extent();
+    long const nB = mat.dimB.sparse_extent();
+
+    // Double-buffer: while batch ib is regridded, the other buffer
+    // has batch ib-1 written out of it, then batch ib+1 read into it.
+    std::array<Batch,2> batches;
+    for (auto &batch : batches) {
+        batch.valA_s.reference(blitz::Array<double,2>(nbatch, nA));
+        batch.valB_s.reference(blitz::Array<double,2>(nbatch, nB));
+    }
+
+    int const nb = (ntime + nbatch - 1) / nbatch;
+    if (nb == 0) return;
+
+    read_batch(ivar, batches[0], 0, std::min(nbatch, ntime));
+    for (int ib=0; ib<nb; ++ib) {
+        Batch &batch(batches[ib%2]);
+        Batch &other(batches[(ib+1)%2]);
+
+        // The only NetCDF calls in flight: one task, in sequence
+        std::future<void> io_f(std::async(std::launch::async, [&, ib]() {
+            if (ib > 0) write_batch(ovar, other);
+            if (ib+1 < nb) {
+                int const t0 = (ib+1)*nbatch;
+                read_batch(ivar, other, t0, std::min(nbatch, ntime-t0));
+            }
+        }));
+
+        regrid_batch(mat, batch);
+        printf("    Regridded time %d-%d of %d\n", batch.t0, batch.t0+batch.nt, ntime);
+
+        io_f.get();
+    }
+    write_batch(ovar, batches[(nb-1)%2]);
+}
+
+// ==========================================================
+int main(int argc, char **argv)
+{
+    everytrace_init();
+    ParseArgs args(argc, argv);
+
+    // ---------- Load the regridder
+    printf("---- Reading regridder %s\n", args.regridder_fname.c_str());
+    // Only the sheet we regrid for gets its grids loaded
+    GCMRegridder_Standard gcm;
+    gcm.ncread_lazy(args.regridder_fname, args.regridder_vname);
+    int const sheet_index = gcm.ice_regridders().index.at(args.sheet_name);
+
+    // ---------- Load the elevmask
+    blitz::Array<double,1> emI_land, emI_ice;
+    read_elevmask(args.elevmask_spec, emI_land, emI_ice);
+    blitz::Array<double,1> &elevmaskI(args.ice_only ? emI_ice : emI_land);
+
+    MatrixCache matrices(gcm, sheet_index, elevmaskI, args.params);
+
+    // ---------- Regrid each variable
+    NcIO incio(args.ifname, 'r');
+    NcIO oncio(args.ofname, 'w', "nc4");
+    NcDim time_d(oncio.nc->addDim("time"));    // Unlimited
+
+    int ntime = -1;
+    for (auto const &tuple : args.vars) {
+        std::string const &spec_name(std::get<0>(tuple));
+        std::string const &vname(std::get<1>(tuple));
+
+        Matrix const &mat(matrices.at(spec_name));
+
+        // Check input variable's shape
+        NcVar ivar(incio.nc->getVar(vname));
+        if (ivar.isNull()) (*icebin_error)(-1,
+            "Variable %s not found in %s", vname.c_str(), args.ifname.c_str());
+        auto idims(ivar.getDims());
+        long nA = 1;
+        for (size_t i=1; i<idims.size(); ++i) nA *= idims[i].getSize();
+        if (idims.size() < 2 || nA != mat.dimA.sparse_extent()) (*icebin_error)(-1,
+            "Variable %s must have dimensions (time, ...) with %ld grid cells; has %ld",
+            vname.c_str(), mat.dimA.sparse_extent(), nA);
+        int const var_ntime = idims[0].getSize();
+        if (ntime < 0) ntime = var_ntime;
+        else if (var_ntime != ntime) (*icebin_error)(-1,
+            "Variable %s has %d time slices; expected %d",
+            vname.c_str(), var_ntime, ntime);
+
+        // Define output variable, with dimensions in decreasing stride
+        Indexing const &indexingB(*mat.indexingB);
+        std::vector<NcDim> odims {time_d};
+        for (int i : indexingB.indices()) {
+            std::string const dname(spec_name.substr(0,1) + "." + indexingB[i].name);
+            odims.push_back(get_or_add_dim(oncio, dname, indexingB[i].extent));
+        }
+        NcVar ovar(oncio.nc->addVar(vname, ncDouble, odims));
+        ovar.setFill(true, NaN);
+        get_or_put_att(ovar, 'w', "regrid_matrix", spec_name);
+        get_or_put_att(ovar, 'w', "source_file", args.ifname);
+
+        printf("---- Regridding %s (%s)\n", vname.c_str(), spec_name.c_str());
+        regrid_var(mat, ivar, ovar, var_ntime, args.nbatch);
+    }
+
+    // Copy the time coordinate, if it exists
+    NcVar itime(incio.nc->getVar("time"));
+    if (!itime.isNull() && ntime > 0) {
+        std::vector<double> time(ntime);
+        itime.getVar(time.data());
+        NcVar otime(oncio.nc->addVar("time", ncDouble, {time_d}));
+        otime.putVar({0}, {(size_t)ntime}, time.data());
+    }
+
+    incio.close();
+    oncio.close();
+    printf("Done!\n");
+    return 0;
+}
@@ -0,0 +1,121 @@
+/*
+Long-lived local regrid service (see icebin/regrid_service.hpp).
+
+Loads a regridder once, then serves regrid requests from clients on
+the same machine (RegridClient in C++, icebin.RegridClient in Python)
+over a Unix domain socket.  Regrid matrices are cached between
+requests, keyed on (sheet, elevmask, params).
+
+Example:
+    regrid_server -r gcmO.nc --socket /tmp/icebin.sock &
+    ...
+    regrid_server --socket /tmp/icebin.sock --stop
+*/
+
+#include <string>
+#include <iostream>
+
+#include <tclap/CmdLine.h>
+
+#include <ibmisc/netcdf.hpp>
+#include <ibmisc/error.hpp>
+#include <everytrace.h>
+
+#include <icebin/error.hpp>
+#include <icebin/GCMRegridder.hpp>
+#include <icebin/GCMRegridder_Mapped.hpp>
+#include <icebin/regrid_service.hpp>
+
+using namespace std;
+using namespace ibmisc;
+using namespace icebin;
+
+// ==========================================================
+struct ParseArgs {
+    std::string regridder_fname;
+    std::string regridder_vname;
+    std::string mapped_fname;
+    std::string socket_path;
+    int max_entries;
+    bool stop;
+
+    ParseArgs(int argc, char **argv);
+};
+
+ParseArgs::ParseArgs(int argc, char **argv)
+{
+    try {
+        TCLAP::CmdLine cmd("Local regrid service with cached matrices", ' ', "<no-version>");
+
+        TCLAP::ValueArg<std::string> regridder_a("r", "regridder",
+            "Regridder file, written by GCMRegridder::ncio()",
+            false, "gcmO.nc", "regridder file", cmd);
+
+        TCLAP::ValueArg<std::string> regridder_vname_a("", "regridder-vname",
+            "Name of the regridder inside the regridder file",
+            false, "m", "regridder var name", cmd);
+
+        TCLAP::ValueArg<std::string> mapped_a("", "mapped",
+            "Share the regridder's large arrays through this file (eg: in /dev/shm)",
+            false, "", "mapped file", cmd);
+
+        TCLAP::ValueArg<std::string> socket_a("", "socket",
+            "Unix domain socket to listen on",
+            true, "/tmp/icebin.sock", "socket path", cmd);
+
+        TCLAP::ValueArg<int> max_entries_a("", "max-entries",
+            "Most (sheet, elevmask, params) combinations to keep matrices for",
+            false, 16, "count", cmd);
+
+        TCLAP::SwitchArg stop_a("", "stop",
+            "Stop the server listening on --socket, instead of starting one",
+            cmd, false);
+
+        cmd.parse( argc, argv );
+
+        regridder_fname = regridder_a.getValue();
+        regridder_vname = regridder_vname_a.getValue();
+        mapped_fname = mapped_a.getValue();
+        socket_path = socket_a.getValue();
+        max_entries = std::max(1, max_entries_a.getValue());
+        stop = stop_a.getValue();
+    } catch (TCLAP::ArgException &e) { // catch any exceptions
+        std::cerr << "error: " << e.error() << " for arg " << e.argId() << std::endl;
+        exit(1);
+    }
+}
+
+// ==========================================================
+int main(int argc, char **argv)
+{
+    everytrace_init();
+    ParseArgs args(argc, argv);
+
+    if (args.stop) {
+        regrid_service::RegridClient client(args.socket_path);
+        client.shutdown_server();
+        return 0;
+    }
+
+    // ---------- Load the regridder
+    printf("---- Reading regridder %s\n", args.regridder_fname.c_str());
+    std::unique_ptr<GCMRegridder_Standard> gcm;
+    if (args.mapped_fname != "") {
+        gcm = new_GCMRegridder_Mapped(
+            args.regridder_fname, args.regridder_vname, args.mapped_fname);
+    } else {
+        // Sheets load their grids on their first request
+        gcm.reset(new GCMRegridder_Standard);
+        gcm->ncread_lazy(args.regridder_fname, args.regridder_vname);
+    }
+
+    // A bad request must fail that request, not stop the server
+    icebin_error = &throw_error;
+    ibmisc_error = &throw_error;
+
+    regrid_service::RegridServer server(gcm.get(), args.max_entries);
+    server.serve(args.socket_path);
+
+    printf("Done!\n");
+    return 0;
+}
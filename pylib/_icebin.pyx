@@ -78,7 +78,12 @@ cdef class GCMRegridder:
     cdef cibmisc.shared_ptr[cicebin.GCMRegridder] cself
     cdef cibmisc.unique_ptr[cicebin.Grid] fgridA
 
-    def __init__(self, *args):
+    def __init__(self, *args, mapped=None):
+        """mapped: [OPTIONAL]
+            Name of a file (eg: in /dev/shm) holding the regridder's large
+            arrays.  It is created from regridder_fname if needed, and then
+            memory-mapped read-only; so that many worker processes share
+            one copy of the regridder.  Only for GCMRegridder(regridder_fname)."""
         cdef ibmisc.NcIO ncio
 
         # Create a brand new GCMRegridder
@@ -87,6 +92,10 @@ cdef class GCMRegridder:
             
             cicebin.read_fgrid(self.fgridA, gridA_fname.encode(), gridA_vname.encode())
             self.cself = cicebin.new_GCMRegridder_Standard(self.fgridA.get()[0], hcdefs, correctA)
+        elif len(args) == 1 and mapped is not None:
+            (regridder_fname,) = args
+            self.cself = cicebin.new_GCMRegridder_Mapped(
+                regridder_fname.encode(), b'm', mapped.encode())
         elif len(args) == 1:
             self.cself.reset(new cicebin.GCMRegridder_Standard())
             (regridder_fname,) = args
@@ -113,6 +122,16 @@ cdef class GCMRegridder:
         return deref(self.cself).nhc()
 
 
+    def set_hcdefsA(self, offsets, values):
+        """Gives each A cell its own set of elevation classes.
+        offsets: int64[nA+1]
+            Classes of A cell iA are values[offsets[iA]:offsets[iA+1]]
+        values: double[]
+            Elevation classes [m] of all A cells, each cell's sorted ascending."""
+        offsets = np.ascontiguousarray(offsets, dtype='i8')
+        values = np.ascontiguousarray(values, dtype='d')
+        cicebin.GCMRegridder_set_hcdefsA(self.cself.get(), <PyObject *>offsets, <PyObject *>values)
+
     def wA(self, sheet_name, snative, fill=0.):
         """Returns weights (as a vector) of overall grid."""
         if snative == 'native':
@@ -174,10 +193,120 @@ cdef class GCMRegridder:
         rm.cself = crm
         return rm
 
+    def smoothing_matrix(self, str sheet_name, elevmaskI, wI, sigma):
+        """Computes the smoothing matrix used by the coupler for IvA / IvE
+        (icebin::smoothing_matrix()), without regridding anything.
+        elevmaskI:
+            Elevation of each ice grid cell; NaN where masked out.
+        wI:
+            Weight of each ice grid cell; eg: rm.matrix('IvE').wM
+        sigma: (sigma_x, sigma_y, sigma_z)
+            Scale size of the Gaussian smoothing function.
+        returns: scipy.sparse.coo_matrix (nI x nI)"""
+        elevmaskI = np.require(elevmaskI.reshape(-1), dtype=np.double, requirements=['C'])
+        wI = np.require(wI.reshape(-1), dtype=np.double, requirements=['C'])
+        data_rowcol = cicebin.GCMRegridder_smoothing_matrix(
+            self.cself.get(), sheet_name.encode(),
+            <PyObject *>elevmaskI, <PyObject *>wI,
+            sigma[0], sigma[1], sigma[2])
+        nI = len(wI)
+        return scipy.sparse.coo_matrix(data_rowcol, shape=(nI,nI))
+
+def coo_matvec(M, xx, bool ignore_nan=False, double fill=np.nan, int nthread=0):
+    """Computes M * xx, in parallel, for a scipy.sparse matrix M.
+    xx: double[..., ncol]
+        Input; leading dimensions are treated as separate variables
+        (eg: time), and are all regridded with one conversion of M.
+    ignore_nan:
+        If set, NaN values in xx do not contribute to the result.
+    fill:
+        Value for output rows that receive nothing from M.
+    nthread:
+        Number of threads to use (0 = all cores).
+    returns: double[..., nrow]"""
+    M = M.tocoo()
+    nrow,ncol = M.shape
+    leading, (nvar,_) = split_shape(xx.shape, ncol)
+
+    xx2 = np.require(xx.reshape((nvar,ncol)), dtype=np.double, requirements=['C'])
+    yy2 = np.zeros((nvar,nrow))
+    yy2[:] = fill
+    M_row = np.require(M.row, dtype=np.intc, requirements=['C'])
+    M_col = np.require(M.col, dtype=np.intc, requirements=['C'])
+    M_data = np.require(M.data, dtype=np.double, requirements=['C'])
+
+    cicebin.coo_matvec(<PyObject *>yy2, <PyObject *>xx2, ignore_nan,
+        nrow, ncol, <PyObject *>M_row, <PyObject *>M_col, <PyObject *>M_data,
+        nthread)
+    return yy2.reshape(tuple(leading) + (nrow,))
+
 def read_elevmask(xfname):
     """Returns: (emI_land, emI_ice)"""
     return cicebin.read_elevmask(xfname.encode())
 
+cdef class RegridClient:
+    """Connection to a running regrid_server, which keeps the regridder
+    and its regrid matrices loaded between calls."""
+    cdef cicebin.RegridClient *cself
+
+    def __cinit__(self, str socket_path):
+        self.cself = new cicebin.RegridClient(socket_path.encode())
+
+    def __dealloc__(self):
+        del self.cself
+
+    def regrid(self, str sheet_name, str matrix, elevmaskI, valA,
+        bool scale=True, bool correctA=True, sigma=(0,0,0)):
+        """Regrids through the server.
+        matrix:
+            Name of the regrid matrix (eg: 'IvE')
+        elevmaskI:
+            Elevation of each ice grid cell; NaN where masked out.
+        valA: double[..., nA]
+            Input values (sparse indexing); leading dimensions (eg: time)
+            are all regridded in one request.
+        returns: double[..., nB]"""
+        elevmaskI = np.require(elevmaskI.reshape(-1), dtype=np.double, requirements=['C'])
+        leading = valA.shape[:-1]
+        nA = valA.shape[-1]
+        valA2 = np.require(valA.reshape((-1,nA)), dtype=np.double, requirements=['C'])
+        valB2 = cicebin.RegridClient_regrid(self.cself,
+            sheet_name.encode(), matrix.encode(),
+            <PyObject *>elevmaskI, <PyObject *>valA2,
+            scale, correctA, sigma[0], sigma[1], sigma[2])
+        return valB2.reshape(tuple(leading) + (valB2.shape[1],))
+
+    def ping(self):
+        self.cself.ping()
+
+    def shutdown_server(self):
+        self.cself.shutdown_server()
+
+def smoothing_matrix(index, centroid, area, sigma, n=None):
+    """Computes a Gaussian smoothing matrix using the C++ icebin::Smoother.
+    index: int[npoints]
+        Row/column in the matrix of each point
+    centroid: double[npoints,3]
+        (x,y,z) position of each point
+    area: double[npoints]
+        Area (weight) of each point
+    sigma: (sigma_x, sigma_y, sigma_z)
+        Scale size of the Gaussian smoothing function.
+        Use np.inf for any dimension that should not be smoothed on.
+    n:
+        Size of the (square) matrix; default max(index)+1
+    returns: scipy.sparse.coo_matrix (n x n)"""
+    index = np.require(index, dtype=np.intc, requirements=['C'])
+    centroid = np.require(centroid, dtype=np.double, requirements=['C'])
+    area = np.require(area, dtype=np.double, requirements=['C'])
+    if n is None:
+        n = int(index.max())+1 if len(index) > 0 else 0
+
+    data_rowcol = cicebin.Smoother_matrix(
+        <PyObject *>index, <PyObject *>centroid, <PyObject *>area,
+        sigma[0], sigma[1], sigma[2])
+    return scipy.sparse.coo_matrix(data_rowcol, shape=(n,n))
+
 # ============================================================
 
 cdef class HntrSpec:
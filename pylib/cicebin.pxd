@@ -73,6 +73,12 @@ cdef extern from "icebin/GCMRegridder.hpp" namespace "icebin":
     cdef cppclass GCMRegridder_Standard(GCMRegridder):
         GCMRegridder_Standard() except +
 
+cdef extern from "icebin/regrid_service.hpp" namespace "icebin::regrid_service":
+    cdef cppclass RegridClient:
+        RegridClient(string &socket_path) except +
+        void ping() except +
+        void shutdown_server() except +
+
 cdef extern from "icebin_cython.hpp" namespace "icebin::cython":
     cdef void read_fgrid(
         cibmisc.unique_ptr[Grid] &fgridA,
@@ -84,6 +90,11 @@ cdef extern from "icebin_cython.hpp" namespace "icebin::cython":
         vector[double] &hcdefs,
         bool correctA) except +
 
+    cdef cibmisc.shared_ptr[GCMRegridder] new_GCMRegridder_Mapped(
+        string &regridder_fname,
+        string &vname,
+        string &mapped_fname) except +
+
     cdef cibmisc.shared_ptr[GCMRegridder] new_GCMRegridder_WrapE(
         string &global_ecO,
         cibmisc.shared_ptr[GCMRegridder] &gcmO) except +
@@ -93,6 +104,11 @@ cdef extern from "icebin_cython.hpp" namespace "icebin::cython":
         PyObject *foceanAOp_py,
         PyObject *foceanAOm_py) except +
 
+    cdef void GCMRegridder_set_hcdefsA(
+        GCMRegridder *gcm_regridder,
+        PyObject *offsets_py,
+        PyObject *values_py) except +
+
     cdef object GCMRegridder_wA(
         GCMRegridder *gcm_regridder,
         string &sheet_name,
@@ -106,6 +122,11 @@ cdef extern from "icebin_cython.hpp" namespace "icebin::cython":
         string &exgrid_fname, string &exgrid_vname,
         string &sinterp_style) except +
 
+    cdef void coo_matvec(PyObject *yy_py, PyObject *xx_py, bool ignore_nan,
+        size_t M_nrow, size_t M_ncol,
+        PyObject *M_row_py, PyObject *M_col_py, PyObject *M_data_py,
+        int nthread) except +
+
     cdef cibmisc.linear_Weighted *RegridMatrices_matrix(
         RegridMatrices *self, string spec_name) except +
 
@@ -117,6 +138,21 @@ cdef extern from "icebin_cython.hpp" namespace "icebin::cython":
 
     cdef object read_elevmask(string &xfname) except +
 
+    cdef object RegridClient_regrid(
+        RegridClient *client, string &sheet, string &matrix,
+        PyObject *elevmaskI_py, PyObject *valA_py,
+        bool scale, bool correctA,
+        double sigma_x, double sigma_y, double sigma_z) except +
+
+    cdef object Smoother_matrix(
+        PyObject *index_py, PyObject *centroid_py, PyObject *area_py,
+        double sigma_x, double sigma_y, double sigma_z) except +
+
+    cdef object GCMRegridder_smoothing_matrix(
+        GCMRegridder *gcm, string &sheet_name,
+        PyObject *elevmaskI_py, PyObject *wI_py,
+        double sigma_x, double sigma_y, double sigma_z) except +
+
 cdef extern from "icebin/GridSpec.hpp" namespace "icebin":
     pass
 
@@ -18,6 +18,7 @@
 
 #include <cstdio>
 #include <algorithm>
+#include <thread>
 #include <ibmisc/netcdf.hpp>
 #include <ibmisc/cython.hpp>
 #include <spsparse/SparseSet.hpp>
@@ -25,6 +26,9 @@
 #include <icebin/GCMCoupler.hpp>
 #include <icebin/Grid.hpp>
 #include <icebin/ElevMask.hpp>
+#include <icebin/GCMRegridder_Mapped.hpp>
+#include <icebin/smoother.hpp>
+#include <icebin/regrid_service.hpp>
 #ifdef BUILD_MODELE
 #include <icebin/modele/GCMCoupler_ModelE.hpp>
 #endif
@@ -72,6 +76,15 @@ std::shared_ptr<GCMRegridder_Standard> new_GCMRegridder_Standard(
     return cself;
 }
 
+std::shared_ptr<GCMRegridder> new_GCMRegridder_Mapped(
+    std::string const &regridder_fname,
+    std::string const &vname,
+    std::string const &mapped_fname)
+{
+    return std::shared_ptr<GCMRegridder>(
+        icebin::new_GCMRegridder_Mapped(regridder_fname, vname, mapped_fname));
+}
+
 std::shared_ptr<GCMRegridder> new_GCMRegridder_WrapE(
     std::string const &global_ecO,
     std::shared_ptr<GCMRegridder> const &gcmO)
@@ -108,6 +121,19 @@ void GCMRegridder_WrapE_set_focean(
 #endif
 }
 
+void GCMRegridder_set_hcdefsA(
+    GCMRegridder *gcm_regridder,
+    PyObject *offsets_py,
+    PyObject *values_py)
+{
+    auto offsets(np_to_blitz<long,1>(offsets_py, "offsets", {-1}));
+    auto values(np_to_blitz<double,1>(values_py, "values", {-1}));
+
+    gcm_regridder->set_hcdefsA(
+        std::vector<long>(offsets.begin(), offsets.end()),
+        std::vector<double>(values.begin(), values.end()));
+}
+
 PyObject *GCMRegridder_wA(
     GCMRegridder *gcm_regridder,
     std::string const &sheet_name,
@@ -155,40 +181,103 @@ void GCMRegridder_add_sheet(GCMRegridder *cself,
         ->add_sheet(std::move(sheet));
 }
 
-/** Computes yy = M xx.  yy is allocated, not necessarily set. */
+/** Compressed-row form of a COO matrix, for coo_matvec() */
+struct CSRMatrix {
+    std::vector<int> row_start;    // Length nrow+1
+    std::vector<int> col;
+    std::vector<double> data;
+
+    /** Converts from COO with a stable counting sort, so entries
+    within a row keep their COO order (and sums come out bit-for-bit
+    the same as a straight pass over the COO matrix). */
+    CSRMatrix(size_t nrow,
+        blitz::Array<int,1> const &M_row,
+        blitz::Array<int,1> const &M_col,
+        blitz::Array<double,1> const &M_data)
+    : row_start(nrow+1, 0), col(M_data.size()), data(M_data.size())
+    {
+        int const nnz = M_data.size();
+        for (int n=0; n<nnz; ++n) ++row_start[M_row(n)+1];
+        for (size_t i=0; i<nrow; ++i) row_start[i+1] += row_start[i];
+
+        std::vector<int> next(row_start.begin(), row_start.end()-1);
+        for (int n=0; n<nnz; ++n) {
+            int const k = next[M_row(n)]++;
+            col[k] = M_col(n);
+            data[k] = M_data(n);
+        }
+    }
+
+    /** Computes yy = M xx on rows [row0, row1), for every variable.
+    Rows with no (non-NaN) contributions are not written. */
+    void matvec(blitz::Array<double,2> &yy, blitz::Array<double,2> const &xx,
+        bool ignore_nan, int row0, int row1) const
+    {
+        int const nvar = xx.extent(0);
+        for (int ivar=0; ivar<nvar; ++ivar) {
+            for (int row=row0; row<row1; ++row) {
+                bool written = false;
+                double sum = 0;
+                for (int k=row_start[row]; k<row_start[row+1]; ++k) {
+                    double const x = xx(ivar, col[k]);
+
+                    // Ignore NaN in input vector
+                    if (ignore_nan && std::isnan(x)) continue;
+                    sum += data[k] * x;
+                    written = true;
+                }
+                // Just do Snowdrift-style "REPLACE".  "MERGE" was never used.
+                if (written) yy(ivar,row) = sum;
+            }
+        }
+    }
+};
+
+/** Computes yy = M xx, for each of nvar variables.
+Rows of yy that receive nothing from M are left untouched (so the
+caller may pre-fill yy with a fill value).
+@param yy_py double[nvar, M_nrow]; allocated, not necessarily set.
+@param xx_py double[nvar, M_ncol]
+@param nthread Number of threads to use; <=0 means use all cores. */
 void coo_matvec(PyObject *yy_py, PyObject *xx_py, bool ignore_nan,
-    size_t M_nrow, size_t M_ncol, PyObject *M_row_py, PyObject *M_col_py, PyObject *M_data_py)
+    size_t M_nrow, size_t M_ncol, PyObject *M_row_py, PyObject *M_col_py, PyObject *M_data_py,
+    int nthread)
 {
-    auto xx(np_to_blitz<double,1>(xx_py, "xx", {M_ncol}));
-    auto yy(np_to_blitz<double,1>(yy_py, "yy", {M_nrow}));
+    auto xx(np_to_blitz<double,2>(xx_py, "xx", {-1, M_ncol}));
+    auto yy(np_to_blitz<double,2>(yy_py, "yy", {xx.extent(0), M_nrow}));
     auto M_row(np_to_blitz<int,1>(M_row_py, "M_row_py", {-1}));
     auto M_col(np_to_blitz<int,1>(M_col_py, "M_col_py", {-1}));
     auto M_data(np_to_blitz<double,1>(M_data_py, "M_data_py", {-1}));
 
-    // Keep track of which items we've written to.
-    std::vector<bool> written(M_nrow, false);
+    // Convert once; then apply to all variables
+    CSRMatrix const M(M_nrow, M_row, M_col, M_data);
 
-    // Do the multiplication, and we're done!
-    int nnz = M_data.size();
-    for (int n=0; n<nnz; ++n) {
-        size_t row = M_row(n);
-        size_t col = M_col(n);
-        double data = M_data(n);
+    // Split rows into chunks of about equal nnz, one per thread
+    if (nthread <= 0) nthread = std::max(1u, std::thread::hardware_concurrency());
+    int const nnz = M.data.size();
+    nthread = std::max(1, std::min(nthread, nnz / 10000));    // Not worth it for small matrices
 
-        // Ignore NaN in input vector
-        if (ignore_nan && std::isnan(xx(col))) continue;
+    std::vector<int> bounds {0};
+    for (int t=1; t<nthread; ++t) {
+        long const target = (long)nnz * t / nthread;
+        bounds.push_back(std::lower_bound(
+            M.row_start.begin()+bounds.back(), M.row_start.end()-1, target)
+            - M.row_start.begin());
+    }
+    bounds.push_back(M_nrow);
 
-        // Just do Snowdrift-style "REPLACE".  "MERGE" was never used.
-        double old_yy;
-        if (written[row]) {
-            old_yy = yy(row);
-        } else {
-            old_yy = 0;
-            written[row] = true;
-        }
-        yy(row) = old_yy + data * xx(col);
+    if (nthread == 1) {
+        M.matvec(yy, xx, ignore_nan, 0, M_nrow);
+        return;
     }
 
+    // Threads write to disjoint rows of yy; no locking needed.
+    std::vector<std::thread> threads;
+    for (int t=0; t<nthread; ++t) {
+        threads.push_back(std::thread(&CSRMatrix::matvec, &M,
+            std::ref(yy), std::cref(xx), ignore_nan, bounds[t], bounds[t+1]));
+    }
+    for (auto &th : threads) th.join();
 }
 
 
@@ -260,4 +349,122 @@ PyObject *read_elevmask(std::string const &xfname)
     return ret;
 }
 
+PyObject *RegridClient_regrid(
+    regrid_service::RegridClient *client,
+    std::string const &sheet,
+    std::string const &matrix,
+    PyObject *elevmaskI_py,
+    PyObject *valA_py,
+    bool scale,
+    bool correctA,
+    double sigma_x,
+    double sigma_y,
+    double sigma_z)
+{
+    auto elevmaskI(np_to_blitz<double,1>(elevmaskI_py, "elevmaskI", {-1}));
+    auto valA(np_to_blitz<double,2>(valA_py, "valA", {-1,-1}));
+
+    blitz::Array<double,2> valB(client->regrid(sheet, matrix, elevmaskI,
+        RegridParams(scale, correctA, {sigma_x, sigma_y, sigma_z}), valA));
+
+    PyObject *valB_py = ibmisc::cython::new_pyarray<double,2>(
+        std::array<int,2>{valB.extent(0), valB.extent(1)});
+    auto valB_b(np_to_blitz<double,2>(valB_py, "valB", {-1,-1}));
+    valB_b = valB;
+    return valB_py;
+}
+
+/** Converts a (dense-indexed) smoothing matrix to the tuple
+(data, (row, col)) accepted by scipy.sparse.coo_matrix().
+@param dimX If non-NULL, translate dense indices back to sparse. */
+static PyObject *smoothing_to_coo(TupleListT<2> const &M, SparseSetT const *dimX)
+{
+    int const nnz = M.size();
+    PyObject *data_py = ibmisc::cython::new_pyarray<double,1>(std::array<int,1>{nnz});
+    PyObject *row_py = ibmisc::cython::new_pyarray<long,1>(std::array<int,1>{nnz});
+    PyObject *col_py = ibmisc::cython::new_pyarray<long,1>(std::array<int,1>{nnz});
+    auto data(np_to_blitz<double,1>(data_py, "data", {-1}));
+    auto row(np_to_blitz<long,1>(row_py, "row", {-1}));
+    auto col(np_to_blitz<long,1>(col_py, "col", {-1}));
+
+    int n=0;
+    for (auto ii=M.begin(); ii != M.end(); ++ii, ++n) {
+        if (dimX) {
+            row(n) = dimX->to_sparse(ii->index(0));
+            col(n) = dimX->to_sparse(ii->index(1));
+        } else {
+            row(n) = ii->index(0);
+            col(n) = ii->index(1);
+        }
+        data(n) = ii->value();
+    }
+
+    PyObject *rowcol = PyTuple_New(2);
+        PyTuple_SetItem(rowcol, 0, row_py);
+        PyTuple_SetItem(rowcol, 1, col_py);
+    PyObject *ret = PyTuple_New(2);
+        PyTuple_SetItem(ret, 0, data_py);
+        PyTuple_SetItem(ret, 1, rowcol);
+    return ret;
+}
+
+PyObject *Smoother_matrix(
+    PyObject *index_py,
+    PyObject *centroid_py,
+    PyObject *area_py,
+    double sigma_x,
+    double sigma_y,
+    double sigma_z)
+{
+    auto index(np_to_blitz<int,1>(index_py, "index", {-1}));
+    int const n = index.extent(0);
+    auto centroid(np_to_blitz<double,2>(centroid_py, "centroid", {n, 3}));
+    auto area(np_to_blitz<double,1>(area_py, "area", {n}));
+
+    std::vector<Smoother::Tuple> tuples;
+    tuples.reserve(n);
+    for (int i=0; i<n; ++i) {
+        tuples.push_back(Smoother::Tuple(index(i),
+            {centroid(i,0), centroid(i,1)}, centroid(i,2), area(i)));
+    }
+
+    TupleListT<2> M;
+    Smoother smoother(std::move(tuples), {sigma_x, sigma_y, sigma_z});
+    smoother.matrix(M);
+
+    return smoothing_to_coo(M, nullptr);
+}
+
+PyObject *GCMRegridder_smoothing_matrix(
+    GCMRegridder const *gcm,
+    std::string const &sheet_name,
+    PyObject *elevmaskI_py,
+    PyObject *wI_py,
+    double sigma_x,
+    double sigma_y,
+    double sigma_z)
+{
+    IceRegridder const *ice_regridder = &*gcm->ice_regridders().at(sheet_name);
+    long const nI = ice_regridder->nI();
+    auto elevmaskI(np_to_blitz<double,1>(elevmaskI_py, "elevmaskI", {nI}));
+    auto wI(np_to_blitz<double,1>(wI_py, "wI", {nI}));
+
+    // dimI = ice grid cells that participate in the regrid (non-zero weight);
+    // as in compute_IvAE(), where wM has been computed on dimI.
+    SparseSetT dimI;
+    dimI.set_sparse_extent(nI);
+    for (long iI=0; iI<nI; ++iI) {
+        if (wI(iI) != 0) dimI.add_dense(iI);
+    }
+    DenseArrayT<1> wI_d(dimI.dense_extent());
+    for (int iI_d=0; iI_d<dimI.dense_extent(); ++iI_d)
+        wI_d(iI_d) = wI(dimI.to_sparse(iI_d));
+
+    TupleListT<2> M({dimI.dense_extent(), dimI.dense_extent()});
+    smoothing_matrix(M, ice_regridder->agridI(),
+        dimI, elevmaskI, wI_d, {sigma_x, sigma_y, sigma_z});
+
+    return smoothing_to_coo(M, &dimI);
+}
+
 }}
@@ -23,6 +23,7 @@
 #include <icebin/GCMRegridder.hpp>
 #include <icebin/modele/hntr.hpp>
 #include <icebin/ElevMask.hpp>
+#include <icebin/regrid_service.hpp>
 
 namespace icebin {
 namespace cython {
@@ -38,6 +39,13 @@ extern std::shared_ptr<GCMRegridder_Standard> new_GCMRegridder_Standard(
     bool _correctA);
 
 
+/** Loads a GCMRegridder whose large arrays are shared (read-only)
+among processes through a memory-mapped file.  See GCMRegridder_Mapped.hpp */
+extern std::shared_ptr<GCMRegridder> new_GCMRegridder_Mapped(
+    std::string const &regridder_fname,
+    std::string const &vname,
+    std::string const &mapped_fname);
+
 /** Instantiates a new C++ object of type GCMRegridder_ModelE.
 NOTE: This function is only enabled if BUILD_MODELE is enabled in CMake. */
 extern std::shared_ptr<GCMRegridder> new_GCMRegridder_WrapE(
@@ -53,6 +61,14 @@ extern void GCMRegridder_WrapE_set_focean(
     PyObject *foceanAOp_py,
     PyObject *foceanAOm_py);
 
+/** Installs per-A-cell elevation classes (see GCMRegridder::hcdefsA_offsets)
+@param offsets_py int64[nA+1] Start of each A cell's classes in values_py
+@param values_py double Elevation classes of all A cells, concatenated */
+extern void GCMRegridder_set_hcdefsA(
+    GCMRegridder *gcm_regridder,
+    PyObject *offsets_py,
+    PyObject *values_py);
+
 extern PyObject *GCMRegridder_wA(
     GCMRegridder *gcm_regridder,
     std::string const &sheet_name,
@@ -67,6 +83,15 @@ extern void GCMRegridder_add_sheet(GCMRegridder *cself,
     std::string const &sinterp_style);
 
 
+/** Computes yy = M xx (M in COO form) for nvar variables at once,
+using multiple threads.  Rows of yy not touched by M are left alone.
+@param yy_py double[nvar, M_nrow]
+@param xx_py double[nvar, M_ncol]
+@param nthread Number of threads; <=0 to use all cores. */
+extern void coo_matvec(PyObject *yy_py, PyObject *xx_py, bool ignore_nan,
+    size_t M_nrow, size_t M_ncol, PyObject *M_row_py, PyObject *M_col_py, PyObject *M_data_py,
+    int nthread);
+
 extern ibmisc::linear::Weighted *RegridMatrices_matrix(RegridMatrices *cself,
     std::string const &spec_name);
 
@@ -89,6 +114,48 @@ RegridMatrices *new_regrid_matrices(
 PyObject *read_elevmask(
     std::string const &xfname);
 
+/** Regrids through a running regrid_server (see icebin/regrid_service.hpp)
+@param valA_py double[nt, nA] Input values, sparse indexing
+@return double[nt, nB] */
+PyObject *RegridClient_regrid(
+    regrid_service::RegridClient *client,
+    std::string const &sheet,
+    std::string const &matrix,
+    PyObject *elevmaskI_py,
+    PyObject *valA_py,
+    bool scale,
+    bool correctA,
+    double sigma_x,
+    double sigma_y,
+    double sigma_z);
+
+/** Runs icebin::Smoother on a set of points supplied from Python.
+@param index_py Index of each point (becomes row/column in the matrix)
+@param centroid_py Position of each point; shape (n,3).
+@param area_py Area (weight) of each point.
+@return (data, (row, col)), suitable for scipy.sparse.coo_matrix() */
+PyObject *Smoother_matrix(
+    PyObject *index_py,
+    PyObject *centroid_py,
+    PyObject *area_py,
+    double sigma_x,
+    double sigma_y,
+    double sigma_z);
+
+/** Computes the same IvE / IvA smoothing matrix the coupler uses
+(icebin::smoothing_matrix()), for one ice sheet.
+@param elevmaskI_py Elevation of each ice grid cell (NaN where masked out).
+@param wI_py Weight of each ice grid cell (eg: from the IvE matrix).
+@return (data, (row, col)) in sparse I indexing. */
+PyObject *GCMRegridder_smoothing_matrix(
+    GCMRegridder const *gcm,
+    std::string const &sheet_name,
+    PyObject *elevmaskI_py,
+    PyObject *wI_py,
+    double sigma_x,
+    double sigma_y,
+    double sigma_z);
+
 /** Allows Python users access to GCMCoupler_Modele::update_topo().
 Starting from output of Gary's program (on the Ocean grid), this subroutine
 produces a ModelE TOPO file (as internal arrays) on the Atmosphere grid. */
@@ -20,8 +20,30 @@ ExchangeGrid::ExchangeGrid(Grid const &g)
     }
 }
 
+void ExchangeGrid::map(std::shared_ptr<void const> const &_mapping,
+    int const *_indices, double const *_overlaps, int n)
+{
+    indices.clear();
+    overlaps.clear();
+    mapping = _mapping;
+    mindices = _indices;
+    moverlaps = _overlaps;
+    mn = n;
+}
+
+void ExchangeGrid::unmap()
+{
+    indices.assign(mindices, mindices + mn*2);
+    overlaps.assign(moverlaps, moverlaps + mn);
+    mapping.reset();
+    mindices = nullptr;
+    moverlaps = nullptr;
+    mn = 0;
+}
+
 void ExchangeGrid::ncio(ibmisc::NcIO &ncio, std::string const &vname)
 {
+    if (mapping) unmap();
     ncio_vector(ncio, indices, true, vname + ".indices", "int",
         get_or_add_dims(ncio, indices, {vname + ".nindices"}));
     ncio_vector(ncio, overlaps, true, vname + ".overlaps", "double",
@@ -32,6 +54,8 @@ void ExchangeGrid::ncio(ibmisc::NcIO &ncio, std::string const &vname)
 /** Filters overlaps based on the destination (BvA = B = index[0]) grid. */
 void ExchangeGrid::filter_cellsB(std::function<bool(long)> const &keep_B_fn)
 {
+    if (mapping) unmap();
+
     std::vector<int> _indices;    // Length*2: (ixB, ixA)
     std::vector<double> _overlaps;
 
@@ -78,6 +102,7 @@ void AbbrGrid::clear()
     ijk.free();
     native_area.free();
     centroid_xy.free();
+    mapping.reset();
 }
 
 
@@ -164,7 +189,7 @@ void AbbrGrid::filter_cells(std::function<bool(long)> const &keep_fn)
 }
 
 
-void AbbrGrid::ncio(ibmisc::NcIO &ncio, std::string const &vname)
+void AbbrGrid::ncio_meta(ibmisc::NcIO &ncio, std::string const &vname)
 {
     ncio_grid_spec(ncio, spec, vname);
 
@@ -175,6 +200,11 @@ void AbbrGrid::ncio(ibmisc::NcIO &ncio, std::string const &vname)
     get_or_put_att(info_v, ncio.rw, "sproj", sproj);
 
     indexing.ncio(ncio, vname + ".indexing");
+}
+
+void AbbrGrid::ncio(ibmisc::NcIO &ncio, std::string const &vname)
+{
+    ncio_meta(ncio, vname);
 
     // Store dim; retrieve dimension from it
     dim.ncio(ncio, vname + ".dim");
@@ -212,6 +242,7 @@ void AbbrGrid::operator=(AbbrGrid &&other)
     ijk.reference(other.ijk);
     native_area.reference(other.native_area);
     centroid_xy.reference(other.centroid_xy);
+    mapping = other.mapping;
 }
 
 AbbrGrid::AbbrGrid(AbbrGrid &&other)
@@ -233,6 +264,7 @@ void AbbrGrid::operator=(AbbrGrid const &other)
     ijk.reference(other.ijk);
     native_area.reference(other.native_area);
     centroid_xy.reference(other.centroid_xy);
+    mapping = other.mapping;
 }
 
 AbbrGrid::AbbrGrid(AbbrGrid const &other)
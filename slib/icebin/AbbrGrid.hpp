@@ -19,6 +19,7 @@
 #pragma once
 
 #include <vector>
+#include <memory>
 #include <unordered_map>
 #include <functional>
 
@@ -42,30 +43,52 @@ class ExchangeGrid {
     std::vector<int> indices;    // Length*2: (ixB, ixA)
     std::vector<double> overlaps;
 
+    // Read-only view of indices / overlaps, when they live in a memory
+    // mapped file (see GCMRegridder_Mapped.hpp).  Used instead of
+    // indices and overlaps if mapping is set.
+    std::shared_ptr<void const> mapping;
+    int const *mindices = nullptr;
+    double const *moverlaps = nullptr;
+    int mn = 0;
+
+    /** Copies a mapped ExchangeGrid into private memory, so it may be modified. */
+    void unmap();
+
 public:
     ExchangeGrid() {}
 
     /** Only works for Grid objects resulting from the overlap program. */
     explicit ExchangeGrid(Grid const &g);
 
+    /** Uses externally-owned (read-only) arrays in place of our own.
+    @param _mapping Keeps the external memory alive as long as we use it.
+    @param _indices Length n*2: (ixB, ixA)
+    @param _overlaps Length n */
+    void map(std::shared_ptr<void const> const &_mapping,
+        int const *_indices, double const *_overlaps, int n);
+
+    bool is_mapped() const { return (bool)mapping; }
+
     void reserve(size_t n)
     {
+        if (mapping) unmap();
         indices.reserve(n*2);
         overlaps.reserve(n);
     }
 
     void add(std::array<int,2> const &index, double _area)
     {
+        if (mapping) unmap();
         indices.push_back(index[0]);
         indices.push_back(index[1]);
         overlaps.push_back(_area);
     }
 
     int dense_extent() const 
-        { return overlaps.size(); }
+        { return mapping ? mn : overlaps.size(); }
 
     long sparse_extent() const
-        { return overlaps.size(); }
+        { return dense_extent(); }
 
     /** Exchange gridcells are numbered in order from 0.
     Therefore, dense and sparse indexing are equivalent. */
@@ -73,9 +96,9 @@ public:
         { return id; }
 
     int ijk(int id, int index) const
-        { return indices[id*2 + index]; }
+        { return (mapping ? mindices : indices.data())[id*2 + index]; }
     double native_area(int id) const
-        { return overlaps[id]; }
+        { return (mapping ? moverlaps : overlaps.data())[id]; }
 
     void ncio(ibmisc::NcIO &ncio, std::string const &vname);
 
@@ -108,8 +131,17 @@ struct AbbrGrid {
     // Only set if coordinates == GridCoordinates::XY
     blitz::Array<double,2> centroid_xy;    // centroid(index, xy)
 
+    /** Set if ijk, native_area and centroid_xy point into read-only
+    memory owned by someone else (see GCMRegridder_Mapped.hpp).  Keeps
+    that memory alive as long as this AbbrGrid (or a copy) uses it. */
+    std::shared_ptr<void const> mapping;
+
     virtual void ncio(ibmisc::NcIO &ncio, std::string const &vname);
 
+    /** Reads / writes everything except dim, ijk, native_area and
+    centroid_xy (i.e. the parts that scale with grid size). */
+    void ncio_meta(ibmisc::NcIO &ncio, std::string const &vname);
+
     AbbrGrid() {}
     explicit AbbrGrid(Grid const &g);
 
@@ -29,6 +29,7 @@
 #include <icebin/GCMRegridder.hpp>
 #include <icebin/contracts/contracts.hpp>
 #include <icebin/e1ve0.hpp>
+#include <icebin/shared_store.hpp>
 #include <spsparse/netcdf.hpp>
 
 #ifdef USE_PISM
@@ -101,13 +102,26 @@ std::string GCMCoupler::sdate(double time_s) const
 }
 
 
-/** Static-cast a unique_ptr while moving it to another unique_ptr */
-template<typename D, typename B>
-void static_move(std::shared_ptr<D> &dest, std::unique_ptr<B>& base)
+/** Regridders shared among ensemble members, keyed on (fname, vname) */
+static SharedStore<std::pair<std::string, std::string>, GCMRegridder_Standard> shared_gcm_regridders;
+
+static std::shared_ptr<GCMRegridder_Standard> load_gcm_regridder(
+    std::string const &grid_fname, std::string const &vname)
 {
-    dest.reset(static_cast<D*>(base.release()));
+    std::shared_ptr<GCMRegridder_Standard> gcmr(new GCMRegridder_Standard());
+    NcIO ncio_grid(grid_fname, NcFile::read);
+    gcmr->ncio(ncio_grid, vname);
+    return gcmr;
 }
 
+std::shared_ptr<GCMRegridder_Standard> get_gcm_regridder(
+    std::string const &grid_fname, std::string const &vname, bool share)
+{
+    if (!share) return load_gcm_regridder(grid_fname, vname);
+    return shared_gcm_regridders.get(
+        std::make_pair(grid_fname, vname),
+        std::bind(&load_gcm_regridder, grid_fname, vname));
+}
 
 /** @param nc The IceBin configuration file */
 void GCMCoupler::_ncread(
@@ -126,12 +140,7 @@ void GCMCoupler::_ncread(
 
     // Load the MatrixMaker (filtering by our domain, of course)
     // Also load the ice sheets
-    {
-        std::unique_ptr<GCMRegridder_Standard> gcmr(new GCMRegridder_Standard());
-        NcIO ncio_grid(grid_fname, NcFile::read);
-        gcmr->ncio(ncio_grid, vname);
-        static_move(gcm_regridder, gcmr);    // Move gcm_regridder <- gcm
-    }
+    gcm_regridder = get_gcm_regridder(grid_fname, vname, gcm_params.share_regridders);
 
     std::cout << "========= GCM Constants" << std::endl;
     std::cout << gcm_constants;
@@ -154,7 +163,7 @@ void GCMCoupler::_ncread(
             ncio_config, vname, ice_regridder->name(), this));
 
         // Add to basesX and areaX (X = combined exchange grid for all ice sheets)
-        auto const &aexgrid(ice_regridder->aexgrid);    // Exchange grid
+        auto const &aexgrid(ice_regridder->aexgrid());    // Exchange grid
         basesX.push_back(basesX.back() + aexgrid.sparse_extent());
         for (int iXd=0; iXd<aexgrid.dense_extent(); ++iXd) {
             areaX.push_back(aexgrid.native_area(iXd));
@@ -362,6 +371,11 @@ void GCMCoupler::ncio_gcm_input(NcIO &ncio,
 void GCMCoupler::ncio_rsf(ibmisc::NcIO &ncio)
 {
 
+    // Writes are deferred until the NcIO is closed, so XuE0s must
+    // stay decompressed from here on.
+    for (size_t i=0; i < XuE0s_z.size(); ++i) unstash(XuE0s[i]->M, XuE0s_z[i]);
+    XuE0s_z.clear();
+
     // Allocate space to read...
     if (ncio.rw == 'r') {
         XuE0s.clear();
@@ -507,11 +521,20 @@ printf("AA2\n");
 
         // --------- Compute E1vE0
         if (run_ice) {
+            for (size_t i=0; i < XuE0s_z.size(); ++i) unstash(XuE0s[i]->M, XuE0s_z[i]);
             out.E1vE0c = e1ve0::compute_E1vE0c(
                 XuE1s, XuE0s,
                 gcm_regridder->nE(), areaX);
         }
         XuE0s = std::move(XuE1s);    // save state between timesteps
+
+        // Not needed again until next timestep
+        if (gcm_params.compress_held_matrices) {
+            XuE0s_z.clear();
+            XuE0s_z.resize(XuE0s.size());
+            for (size_t i=0; i < XuE0s.size(); ++i) stash(XuE0s[i]->M, XuE0s_z[i]);
+            for (auto &ice_coupler : ice_couplers) stash(ice_coupler->IvE0, ice_coupler->IvE0_z);
+        }
     }
 
     return out;
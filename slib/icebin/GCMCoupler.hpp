@@ -32,6 +32,7 @@
 #include <icebin/VarSet.hpp>
 #include <icebin/multivec.hpp>
 #include <icebin/e1ve0.hpp>
+#include <icebin/zeigen.hpp>
 
 namespace icebin {
 
@@ -66,6 +67,11 @@ struct GCMInput {
     // NOTE: Actual regrid matrix = I + E1vE0c
     spsparse::TupleList<int,double,2> E1vE0c;
 
+    // Set by the MPI root when E1vE0c is identical to what it sent this
+    // rank last time; E1vE0c is then left off the wire and the receiver
+    // reuses its previous copy.
+    bool E1vE0c_unchanged = false;
+
     /** @param nvar Array specifying number of variables for each segment (A,E,ATOPO,ETOPO). */
     GCMInput(std::vector<int> const &nvar);
     /** @return Number of variables for each segment. */
@@ -74,13 +80,15 @@ struct GCMInput {
     void clear() {
         gcm_ivalss_s.clear();
         E1vE0c.clear();
+        E1vE0c_unchanged = false;
     }
 
     template<class ArchiveT>
     void serialize(ArchiveT &ar, const unsigned int file_version)
     {
         ar & gcm_ivalss_s;
-        ar & E1vE0c;
+        ar & E1vE0c_unchanged;
+        if (!E1vE0c_unchanged) ar & E1vE0c;
     }
 };
 // =============================================================================
@@ -102,6 +110,13 @@ inline HCSegmentData const &get_segment(std::vector<HCSegmentData> const &hc_seg
 /** Parses a spec. string (eg: "legacy,sealand,ec") to a usable set of HCSegments. */
 extern std::vector<HCSegmentData> parse_hc_segments(std::string const &str);
 
+/** Reads a GCMRegridder_Standard from a grid file.
+@param share If set, return the copy already loaded by another coupler
+    in this process from the same (grid_fname, vname), if any.  See
+    GCMParams::share_regridders. */
+extern std::shared_ptr<GCMRegridder_Standard> get_gcm_regridder(
+    std::string const &grid_fname, std::string const &vname, bool share);
+
 /** Parameters passed from the GCM through to the ice model.
 These parameters cannot be specific to either the ice model or the GCM.
 TODO: Make procedure to read rundeck params and set this stuff up. */
@@ -124,6 +139,30 @@ struct GCMParams {
     // Should IceBin update topography?
     bool dynamic_topo = false;
 
+    // Tolerances for reusing regrid matrices (and TOPO) when the ice
+    // model's elevations have changed only a little since they were
+    // last built.  A negative rebuild_max_delev disables reuse.
+    double rebuild_max_delev = -1;    // [m] Largest allowed elevation change in any ice or land cell
+    long rebuild_max_ncross = 0;      // Number of ice cells allowed to change mask or elevation class
+
+    // Should IceBin record per-regrid conservation budgets?
+    // (see ConservationAuditor)
+    bool audit_conservation = false;
+
+    // Send GCM inputs from root to ranks in single precision?
+    bool scatter_float = false;
+
+    // Ensemble mode: share immutable regridders (grids, exchange
+    // grids, base matrices) with other couplers in this process that
+    // load the same files.  Per-member state (elevmasks, XuE0s, ice
+    // couplers) is never shared.  See SharedStore.
+    bool share_regridders = false;
+
+    // Keep IvE0 and XuE0s compressed in memory (see ZEigenSparse)
+    // between coupling steps, at the cost of compressing and
+    // decompressing them once per step.
+    bool compress_held_matrices = false;
+
     int const icebin_base_hc = 0;    // First GCM elevation class that is an IceBin class (0-based indexing)
 
     GCMParams(MPI_Comm _gcm_comm, int _gcm_root);
@@ -210,6 +249,8 @@ public:
 
     /** XuE matrices from last timestep, used to compute E1vE0 */
     std::vector<std::unique_ptr<ibmisc::linear::Weighted_Eigen>> XuE0s;
+    /** Compressed XuE0s[i]->M, if GCMParams::compress_held_matrices */
+    std::vector<ZEigenSparse> XuE0s_z;
 
     // Fields we read from the config file...
 
@@ -17,6 +17,7 @@
  */
 
 #include <cstdio>
+#include <algorithm>
 #include <spsparse/netcdf.hpp>
 #include <icebin/GCMRegridder.hpp>
 #include <icebin/Grid.hpp>
@@ -85,8 +86,39 @@ void GCMRegridder_Standard::init(
     indexingE = derive_indexingE(agridA->indexing, indexingHC);
 }
 // -------------------------------------------------------------
+void GCMRegridder::set_hcdefsA(std::vector<long> &&offsets, std::vector<double> &&values)
+{
+    if (offsets.size() == 0) {
+        // Revert to the same classes for every cell
+        hcdefsA_offsets.clear();
+        hcdefsA_values.clear();
+        return;
+    }
 
-// -------------------------------------------------------------
+    if (offsets.size() != nA() + 1) (*icebin_error)(-1,
+        "hcdefsA_offsets has size %ld; it must be nA+1 = %ld",
+        (long)offsets.size(), (long)nA() + 1);
+    if (offsets[0] != 0 || offsets.back() != (long)values.size()) (*icebin_error)(-1,
+        "hcdefsA_offsets must run from 0 to %ld", (long)values.size());
+
+    unsigned int nhc_max = 0;
+    for (size_t iA=0; iA+1 < offsets.size(); ++iA) {
+        if (offsets[iA+1] < offsets[iA]) (*icebin_error)(-1,
+            "hcdefsA_offsets decreases at iA=%ld", (long)iA);
+        nhc_max = std::max(nhc_max, (unsigned int)(offsets[iA+1] - offsets[iA]));
+        for (long k=offsets[iA]+1; k < offsets[iA+1]; ++k) {
+            if (values[k] <= values[k-1]) (*icebin_error)(-1,
+                "Elevation classes of iA=%ld are not sorted", (long)iA);
+        }
+    }
+
+    if (nhc_max > indexingHC[1].extent) (*icebin_error)(-1,
+        "Cells have up to %d elevation classes, but indexingHC only has room for %ld",
+        nhc_max, (long)indexingHC[1].extent);
+
+    hcdefsA_offsets = std::move(offsets);
+    hcdefsA_values = std::move(values);
+}
 // ==============================================================
 void GCMRegridder::ncio(ibmisc::NcIO &ncio, std::string const &vname)
 {
@@ -97,6 +129,8 @@ void GCMRegridder_Standard::clear()
 {
     agridA->clear();
     _hcdefs.clear();
+    hcdefsA_offsets.clear();
+    hcdefsA_values.clear();
     ice_regridders().index.clear();
     ice_regridders().clear();
 }
@@ -121,6 +155,18 @@ void GCMRegridder_Standard::ncio(NcIO &ncio, std::string const &vname)
     indexingE.ncio(ncio, vname + ".indexingE");
     ncio_vector(ncio, _hcdefs, true, vname + ".hcdefs", "double",
         get_or_add_dims(ncio, {vname + ".nhc"}, {(long)_hcdefs.size()} ));
+
+    // Per-A-cell elevation classes are optional
+    std::string const hcdefsA_vname = vname + ".hcdefsA_offsets";
+    bool const has_hcdefsA = (ncio.rw == 'r'
+        ? !ncio.nc->getVar(hcdefsA_vname).isNull()
+        : hcdefsA_offsets.size() > 0);
+    if (has_hcdefsA) {
+        ncio_vector(ncio, hcdefsA_offsets, true, hcdefsA_vname, "int64",
+            get_or_add_dims(ncio, {hcdefsA_vname + ".length"}, {(long)hcdefsA_offsets.size()} ));
+        ncio_vector(ncio, hcdefsA_values, true, vname + ".hcdefsA_values", "double",
+            get_or_add_dims(ncio, {vname + ".hcdefsA_values.length"}, {(long)hcdefsA_values.size()} ));
+    }
 //  domainA.ncio(ncio, ncInt, vname + ".domainA");
     get_or_put_att(info_v, ncio.rw, "correctA", &correctA, 1);
 
@@ -137,7 +183,9 @@ void GCMRegridder_Standard::ncio(NcIO &ncio, std::string const &vname)
     if (ncio.rw == 'r') {   // Instantiate
         for (auto sheet_name = sheet_names.begin(); sheet_name != sheet_names.end(); ++sheet_name) {
             std::string vn(vname + "." + *sheet_name);
-            add_sheet(*sheet_name, new_ice_regridder(ncio, vn));
+            std::unique_ptr<IceRegridder> ice_regridder(new_ice_regridder(ncio, vn));
+            ice_regridder->_lazy_fname = _lazy_fname;
+            add_sheet(*sheet_name, std::move(ice_regridder));
         }
     }
     for (auto ice_regridder=ice_regridders().begin(); ice_regridder != ice_regridders().end(); ++ice_regridder) {
@@ -147,6 +195,21 @@ void GCMRegridder_Standard::ncio(NcIO &ncio, std::string const &vname)
 
     indexingE = derive_indexingE(agridA->indexing, indexingHC);
 
+    // Validate per-cell elevation classes
+    if (ncio.rw == 'r' && has_hcdefsA) {
+        std::vector<long> offsets(std::move(hcdefsA_offsets));
+        std::vector<double> values(std::move(hcdefsA_values));
+        set_hcdefsA(std::move(offsets), std::move(values));
+    }
+}
+
+void GCMRegridder_Standard::ncread_lazy(std::string const &fname, std::string const &vname)
+{
+    NcIO ncio(fname, 'r');
+    _lazy_fname = fname;
+    this->ncio(ncio, vname);
+    _lazy_fname = "";
+    ncio.close();
 }
 // -------------------------------------------------------------
 
@@ -194,6 +194,25 @@ extern ibmisc::Indexing derive_indexingE(
     ibmisc::Indexing const &indexingHC);    // iA,iHC
 
 
+// ----------------------------------------------------
+
+/** Elevation class definitions for one GCM grid cell: a read-only
+view into GCMRegridder::_hcdefs or GCMRegridder::hcdefsA_values. */
+struct HCDefsView {
+    double const *_begin;
+    double const *_end;
+
+    HCDefsView(double const *begin, double const *end)
+        : _begin(begin), _end(end) {}
+    HCDefsView(std::vector<double> const &hcdefs)
+        : _begin(hcdefs.data()), _end(hcdefs.data() + hcdefs.size()) {}
+
+    double const *begin() const { return _begin; }
+    double const *end() const { return _end; }
+    size_t size() const { return _end - _begin; }
+    double operator[](size_t ix) const { return _begin[ix]; }
+};
+
 // ----------------------------------------------------
 
 /** Used to index arrays that are done for A and E grids */
@@ -257,6 +276,30 @@ public:
     std::vector<double> const &hcdefs() const
         { return _hcdefs; }
 
+    /** Optional per-A-cell elevation classes, stored as a compact
+    offset/value table: the classes of A cell iA (sparse indexing) are
+    hcdefsA_values[hcdefsA_offsets[iA] .. hcdefsA_offsets[iA+1]).
+    Empty ==> every cell uses _hcdefs.
+    ihc indexes into each cell's own list; so E cells past the end of
+    a cell's list are never generated, and indexingHC need only be
+    sized for the longest list (which sets the size of E).
+    Set with set_hcdefsA(). */
+    std::vector<long> hcdefsA_offsets;    // [nA+1]
+    std::vector<double> hcdefsA_values;
+
+    /** @return Elevation class definitions for A cell iA (sparse indexing) */
+    HCDefsView hcdefs(long iA) const
+    {
+        if (hcdefsA_offsets.size() == 0) return HCDefsView(_hcdefs);
+        return HCDefsView(
+            hcdefsA_values.data() + hcdefsA_offsets[iA],
+            hcdefsA_values.data() + hcdefsA_offsets[iA+1]);
+    }
+
+    /** Installs per-A-cell elevation classes (see hcdefsA_offsets).
+    Each cell's list must be sorted ascending. */
+    void set_hcdefsA(std::vector<long> &&offsets, std::vector<double> &&values);
+
     ibmisc::IndexedVector<std::string, std::unique_ptr<IceRegridder>> &ice_regridders()
         { return *_ice_regridders; }
     ibmisc::IndexedVector<std::string, std::unique_ptr<IceRegridder>> const &ice_regridders() const
@@ -266,7 +309,11 @@ public:
 
     /** @return Number of elevation points for grid cells in general */
     /** @return Number of elevation points for a given grid cell */
-    virtual unsigned int nhc(int i1) const { return (unsigned int)_hcdefs.size(); }
+    virtual unsigned int nhc(int i1) const {
+        if (hcdefsA_offsets.size() == 0) return (unsigned int)_hcdefs.size();
+        if (i1 < 0) return indexingHC[1].extent;
+        return (unsigned int)(hcdefsA_offsets[i1+1] - hcdefsA_offsets[i1]);
+    }
     virtual unsigned int nhc() const { return nhc(-1); }
 
     virtual unsigned long nA() const { return agridA->dim.sparse_extent(); }
@@ -324,6 +371,10 @@ class GCMRegridder_Standard : public GCMRegridder
     /** Ice sheets stored by index defined in sheets_index */
     ibmisc::IndexedVector<std::string, std::unique_ptr<IceRegridder>> mem_ice_regridders;
 
+    /** Set (only) during ncread_lazy(): file the ice sheets will
+    load their grids from. */
+    std::string _lazy_fname;
+
 public:
 
     /** Constructs a blank GCMRegridder.  Typically one will use
@@ -396,6 +447,15 @@ public:
     // -----------------------------------------
     void ncio(ibmisc::NcIO &ncio, std::string const &vname);
 
+    /** Reads like ncio(), except that each ice sheet's grid and
+    exchange grid (the bulk of the file) are not read until that
+    sheet is first used.  Only the A grid, elevation classes and
+    per-sheet metadata are read now; fname must remain readable for
+    the lifetime of this object.
+    @param fname File written by ncio()
+    @param vname Variable name (or prefix) it was written under */
+    void ncread_lazy(std::string const &fname, std::string const &vname);
+
 };  // class GCMRegridder_Standard
 // ===========================================================
 // Special Debugging Functions
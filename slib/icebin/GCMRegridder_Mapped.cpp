@@ -0,0 +1,452 @@
+/*
+ * IceBin: A Coupling Library for Ice Models and GCMs
+ * Copyright (c) 2013-2016 by Elizabeth Fischer
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <fstream>
+#include <boost/filesystem.hpp>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <icebin/GCMRegridder_Mapped.hpp>
+#include <icebin/IceRegridder.hpp>
+
+using namespace ibmisc;
+
+namespace icebin {
+
+static char const MAGIC[8] = {'I','C','E','B','I','N','M','A'};
+static int32_t const VERSION = 2;
+static size_t const ALIGN = 64;    // Cache-line align each array
+
+struct MappedHeader {
+    char magic[8];
+    int32_t version;
+    int32_t narrays;
+
+    // The MappedSource this was made from
+    char source_fname[1024];
+    char source_vname[128];
+    int64_t source_size;
+    int64_t source_mtime;
+};
+
+static bool header_ok(MappedHeader const &header)
+{
+    return memcmp(header.magic, MAGIC, sizeof(MAGIC)) == 0
+        && header.version == VERSION;
+}
+
+static MappedSource header_source(MappedHeader const &header)
+{
+    MappedSource source;
+    source.fname = std::string(header.source_fname,
+        strnlen(header.source_fname, sizeof(header.source_fname)));
+    source.vname = std::string(header.source_vname,
+        strnlen(header.source_vname, sizeof(header.source_vname)));
+    source.size = header.source_size;
+    source.mtime = header.source_mtime;
+    return source;
+}
+
+/** Bytes per element of each MappedArrays::DType */
+static size_t dtype_size(int32_t dtype)
+{
+    switch(dtype) {
+        case MappedArrays::INT : return sizeof(int);
+        case MappedArrays::LONG : return sizeof(long);
+        case MappedArrays::DOUBLE : return sizeof(double);
+        default : return 0;
+    }
+}
+
+// =============================================================
+MappedSource MappedSource::of(std::string const &nc_fname, std::string const &vname)
+{
+    MappedSource source;
+    source.fname = boost::filesystem::absolute(nc_fname).string();
+    source.vname = vname;
+
+    struct stat st;
+    if (stat(nc_fname.c_str(), &st) != 0) (*icebin_error)(-1,
+        "Cannot stat %s: %s", nc_fname.c_str(), strerror(errno));
+    source.size = st.st_size;
+    source.mtime = st.st_mtime;
+    return source;
+}
+
+// =============================================================
+MappedArrays::MappedArrays(std::string const &_fname) : fname(_fname)
+{
+    int fd = ::open(fname.c_str(), O_RDONLY);
+    if (fd < 0) (*icebin_error)(-1,
+        "Cannot open %s: %s", fname.c_str(), strerror(errno));
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) (*icebin_error)(-1,
+        "Cannot stat %s: %s", fname.c_str(), strerror(errno));
+    len = st.st_size;
+    if (len < sizeof(MappedHeader)) (*icebin_error)(-1,
+        "%s is not a mapped IceBin regridder (only %ld bytes)",
+        fname.c_str(), (long)len);
+    void *addr = ::mmap(NULL, len, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);    // Mapping stays valid after close
+    if (addr == MAP_FAILED) (*icebin_error)(-1,
+        "Cannot mmap %s: %s", fname.c_str(), strerror(errno));
+    base = (char const *)addr;
+
+    // Check header and index the arrays
+    auto header((MappedHeader const *)base);
+    if (memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0)
+        (*icebin_error)(-1, "%s is not a mapped IceBin regridder", fname.c_str());
+    if (header->version != VERSION) (*icebin_error)(-1,
+        "%s has version %d, expected %d", fname.c_str(), header->version, VERSION);
+    source = header_source(*header);
+
+    if (header->narrays < 0 || sizeof(MappedHeader)
+        + (size_t)header->narrays * sizeof(Entry) > len) (*icebin_error)(-1,
+        "%s: table of %d arrays runs past end of file (%ld bytes)",
+        fname.c_str(), header->narrays, (long)len);
+
+    // Every array must lie within the file; a truncated file would
+    // otherwise fault (SIGBUS) on first access.
+    auto ee((Entry const *)(base + sizeof(MappedHeader)));
+    for (int i=0; i<header->narrays; ++i) {
+        Entry const &e(ee[i]);
+        if (strnlen(e.name, sizeof(e.name)) == sizeof(e.name)) (*icebin_error)(-1,
+            "%s: array %d has an unterminated name", fname.c_str(), i);
+
+        size_t const esize = dtype_size(e.dtype);
+        if (esize == 0 || e.rank < 1 || e.rank > 2) (*icebin_error)(-1,
+            "%s: array %s has bad dtype=%d or rank=%d",
+            fname.c_str(), e.name, e.dtype, e.rank);
+        uint64_t nbytes = esize;
+        for (int k=0; k<e.rank; ++k) {
+            if (e.shape[k] < 0) (*icebin_error)(-1,
+                "%s: array %s has negative extent", fname.c_str(), e.name);
+            nbytes *= e.shape[k];
+        }
+        if (e.offset < 0 || (uint64_t)e.offset > len || nbytes > len - e.offset)
+            (*icebin_error)(-1,
+            "%s: array %s (offset %ld, %ld bytes) runs past end of file (%ld bytes)",
+            fname.c_str(), e.name, (long)e.offset, (long)nbytes, (long)len);
+
+        entries[e.name] = &e;
+    }
+}
+
+bool MappedArrays::read_source(std::string const &fname, MappedSource &source)
+{
+    std::ifstream fin(fname, std::ios::binary);
+    MappedHeader header;
+    if (!fin.read((char *)&header, sizeof(header))) return false;
+    if (!header_ok(header)) return false;
+    source = header_source(header);
+    return true;
+}
+
+MappedArrays::~MappedArrays()
+{
+    ::munmap((void *)base, len);
+}
+
+MappedArrays::Entry const &MappedArrays::entry(std::string const &name) const
+{
+    auto ii(entries.find(name));
+    if (ii == entries.end()) (*icebin_error)(-1,
+        "Array %s not found in %s", name.c_str(), fname.c_str());
+    return *ii->second;
+}
+
+// =============================================================
+namespace {
+
+/** Accumulates arrays, then writes them in MappedArrays format. */
+class MappedWriter {
+    struct Item {
+        MappedArrays::Entry entry;
+        std::vector<char> data;
+    };
+    std::vector<Item> items;
+
+public:
+    void add(std::string const &name, MappedArrays::DType dtype,
+        std::vector<long> const &shape, long aux,
+        void const *data, size_t nbytes)
+    {
+        if (name.size() >= sizeof(MappedArrays::Entry::name)) (*icebin_error)(-1,
+            "Mapped array name too long: %s", name.c_str());
+
+        items.push_back(Item());
+        Item &item(items.back());
+        memset(&item.entry, 0, sizeof(item.entry));
+        strcpy(item.entry.name, name.c_str());
+        item.entry.dtype = dtype;
+        item.entry.rank = shape.size();
+        for (size_t i=0; i<shape.size(); ++i) item.entry.shape[i] = shape[i];
+        item.entry.aux = aux;
+        item.data.assign((char const *)data, (char const *)data + nbytes);
+    }
+
+    template<class T, int RANK>
+    void add_blitz(std::string const &name, MappedArrays::DType dtype,
+        blitz::Array<T,RANK> const &arr)
+    {
+        // Make a contiguous, C-ordered copy
+        blitz::Array<T,RANK> carr(arr.shape());
+        if (arr.size() > 0) carr = arr;
+
+        std::vector<long> shape;
+        for (int i=0; i<RANK; ++i) shape.push_back(arr.extent(i));
+        add(name, dtype, shape, 0, carr.data(), carr.size()*sizeof(T));
+    }
+
+    void add_dim(std::string const &name, spsparse::SparseSet<long,int> const &dim)
+    {
+        std::vector<long> d2s;
+        d2s.reserve(dim.dense_extent());
+        for (int id=0; id<dim.dense_extent(); ++id) d2s.push_back(dim.to_sparse(id));
+        add(name, MappedArrays::LONG, {(long)d2s.size()}, dim.sparse_extent(),
+            d2s.data(), d2s.size()*sizeof(long));
+    }
+
+    void add_abbr_grid(std::string const &vname, AbbrGrid const &agrid)
+    {
+        add_dim(vname + ".dim", agrid.dim);
+        add_blitz(vname + ".ijk", MappedArrays::INT, agrid.ijk);
+        add_blitz(vname + ".native_area", MappedArrays::DOUBLE, agrid.native_area);
+        add_blitz(vname + ".centroid_xy", MappedArrays::DOUBLE, agrid.centroid_xy);
+    }
+
+    void write(std::string const &fname, MappedSource const &source)
+    {
+        if (source.fname.size() >= sizeof(MappedHeader::source_fname)
+            || source.vname.size() >= sizeof(MappedHeader::source_vname))
+            (*icebin_error)(-1, "Source name too long for mapped file: %s:%s",
+                source.fname.c_str(), source.vname.c_str());
+
+        // Lay out the file
+        size_t offset = sizeof(MappedHeader) + items.size() * sizeof(MappedArrays::Entry);
+        for (auto &item : items) {
+            offset = (offset + ALIGN - 1) / ALIGN * ALIGN;
+            item.entry.offset = offset;
+            offset += item.data.size();
+        }
+
+        // Write to a temporary file, then rename atomically
+        std::string const tmp_fname(fname + ".tmp." + std::to_string(getpid()));
+        {
+            std::ofstream fout(tmp_fname, std::ios::binary);
+            MappedHeader header;
+            memset(&header, 0, sizeof(header));
+            memcpy(header.magic, MAGIC, sizeof(MAGIC));
+            header.version = VERSION;
+            header.narrays = items.size();
+            strcpy(header.source_fname, source.fname.c_str());
+            strcpy(header.source_vname, source.vname.c_str());
+            header.source_size = source.size;
+            header.source_mtime = source.mtime;
+            fout.write((char const *)&header, sizeof(header));
+            for (auto &item : items)
+                fout.write((char const *)&item.entry, sizeof(item.entry));
+
+            char const zeros[ALIGN] = {0};
+            size_t pos = sizeof(MappedHeader) + items.size() * sizeof(MappedArrays::Entry);
+            for (auto &item : items) {
+                fout.write(zeros, item.entry.offset - pos);
+                fout.write(item.data.data(), item.data.size());
+                pos = item.entry.offset + item.data.size();
+            }
+            if (!fout) (*icebin_error)(-1,
+                "Error writing %s", tmp_fname.c_str());
+        }
+        if (rename(tmp_fname.c_str(), fname.c_str()) != 0) (*icebin_error)(-1,
+            "Cannot rename %s to %s: %s", tmp_fname.c_str(), fname.c_str(), strerror(errno));
+    }
+};
+
+/** Rebuilds a SparseSet stored with MappedWriter::add_dim() */
+void read_dim(spsparse::SparseSet<long,int> &dim,
+    MappedArrays const &marr, std::string const &name)
+{
+    auto &e(marr.entry(name));
+    long const *d2s = marr.data<long>(name, MappedArrays::LONG);
+
+    dim.clear();
+    dim.set_sparse_extent(e.aux);
+    for (long id=0; id<e.shape[0]; ++id) dim.add_dense(d2s[id]);
+}
+
+/** Points the big arrays of an AbbrGrid into the mapping. */
+void map_abbr_grid(AbbrGrid &agrid,
+    std::shared_ptr<MappedArrays> const &marr, std::string const &vname)
+{
+    read_dim(agrid.dim, *marr, vname + ".dim");
+    agrid.ijk.reference(marr->blitz_array<int,2>(vname + ".ijk", MappedArrays::INT));
+    agrid.native_area.reference(marr->blitz_array<double,1>(vname + ".native_area", MappedArrays::DOUBLE));
+    agrid.centroid_xy.reference(marr->blitz_array<double,2>(vname + ".centroid_xy", MappedArrays::DOUBLE));
+    agrid.mapping = marr;
+}
+
+/** Holds an exclusive flock() on a file for its lifetime */
+class FileLock {
+    int fd;
+public:
+    FileLock(std::string const &fname)
+    {
+        fd = ::open(fname.c_str(), O_RDWR | O_CREAT, 0666);
+        if (fd < 0) (*icebin_error)(-1,
+            "Cannot open lock file %s: %s", fname.c_str(), strerror(errno));
+        while (flock(fd, LOCK_EX) != 0) {
+            if (errno != EINTR) (*icebin_error)(-1,
+                "Cannot lock %s: %s", fname.c_str(), strerror(errno));
+        }
+    }
+    ~FileLock()
+    {
+        flock(fd, LOCK_UN);
+        ::close(fd);
+    }
+};
+
+}    // anonymous namespace
+// =============================================================
+
+void write_mapped_arrays(
+    GCMRegridder_Standard const &gcm,
+    MappedSource const &source,
+    std::string const &mapped_fname)
+{
+    MappedWriter mw;
+
+    mw.add_abbr_grid("agridA", *gcm.agridA);
+    for (auto const &ice_regridder : gcm.ice_regridders()) {
+        std::string const vn(ice_regridder->name());
+
+        mw.add_blitz(vn + ".gridA_proj_area", MappedArrays::DOUBLE, ice_regridder->gridA_proj_area);
+        mw.add_abbr_grid(vn + ".agridI", ice_regridder->agridI());
+
+        auto const &aexgrid(ice_regridder->aexgrid());
+        int const nX = aexgrid.dense_extent();
+        std::vector<int> indices;
+        std::vector<double> overlaps;
+        indices.reserve(nX*2);
+        overlaps.reserve(nX);
+        for (int id=0; id<nX; ++id) {
+            indices.push_back(aexgrid.ijk(id,0));
+            indices.push_back(aexgrid.ijk(id,1));
+            overlaps.push_back(aexgrid.native_area(id));
+        }
+        mw.add(vn + ".aexgrid.indices", MappedArrays::INT, {nX, 2}, 0,
+            indices.data(), indices.size()*sizeof(int));
+        mw.add(vn + ".aexgrid.overlaps", MappedArrays::DOUBLE, {nX}, 0,
+            overlaps.data(), overlaps.size()*sizeof(double));
+    }
+
+    mw.write(mapped_fname, source);
+}
+
+std::unique_ptr<GCMRegridder_Standard> new_GCMRegridder_Mapped(
+    std::string const &nc_fname,
+    std::string const &vname,
+    std::string const &mapped_fname)
+{
+    MappedSource const source(MappedSource::of(nc_fname, vname));
+
+    // First process to get here (re)creates the mapped file; the
+    // others wait on the lock, then find it up to date.
+    std::shared_ptr<MappedArrays> marr;
+    {FileLock lock(mapped_fname + ".lock");
+        MappedSource mapped_source;
+        if (!MappedArrays::read_source(mapped_fname, mapped_source)
+            || !(mapped_source == source))
+        {
+            GCMRegridder_Standard gcm;
+            NcIO ncio(nc_fname, netCDF::NcFile::read);
+            gcm.ncio(ncio, vname);
+            ncio.close();
+            write_mapped_arrays(gcm, source, mapped_fname);
+        }
+
+        // Map while still holding the lock, so nobody replaces the
+        // file in between.  (A replaced file stays valid for anyone
+        // who already mapped it.)
+        marr = std::make_shared<MappedArrays>(mapped_fname);
+    }
+    if (!(marr->source == source)) (*icebin_error)(-1,
+        "%s was made from %s:%s, not %s:%s", mapped_fname.c_str(),
+        marr->source.fname.c_str(), marr->source.vname.c_str(),
+        source.fname.c_str(), source.vname.c_str());
+    std::unique_ptr<GCMRegridder_Standard> gcm(new GCMRegridder_Standard);
+
+    // Read metadata (everything that does not scale with grid size);
+    // see GCMRegridder_Standard::ncio()
+    NcIO ncio(nc_fname, netCDF::NcFile::read);
+    auto info_v = get_or_add_var(ncio, vname + ".info", "int", {});
+
+    gcm->agridA->ncio_meta(ncio, vname + ".agridA");
+    map_abbr_grid(*gcm->agridA, marr, "agridA");
+
+    gcm->indexingHC.ncio(ncio, vname + ".indexingHC");
+    ncio_vector(ncio, gcm->_hcdefs, true, vname + ".hcdefs", "double",
+        get_or_add_dims(ncio, {vname + ".nhc"}, {(long)gcm->_hcdefs.size()} ));
+    if (!ncio.nc->getVar(vname + ".hcdefsA_offsets").isNull()) {
+        std::vector<long> offsets;
+        std::vector<double> values;
+        ncio_vector(ncio, offsets, true, vname + ".hcdefsA_offsets", "int64",
+            get_or_add_dims(ncio, {vname + ".hcdefsA_offsets.length"}, {0} ));
+        ncio_vector(ncio, values, true, vname + ".hcdefsA_values", "double",
+            get_or_add_dims(ncio, {vname + ".hcdefsA_values.length"}, {0} ));
+        gcm->set_hcdefsA(std::move(offsets), std::move(values));
+    }
+    get_or_put_att(info_v, ncio.rw, "correctA", &gcm->correctA, 1);
+
+    std::vector<std::string> sheet_names;
+    get_or_put_att(info_v, ncio.rw, "sheets", "string", sheet_names);
+
+    for (auto const &sheet_name : sheet_names) {
+        std::string const vn(vname + "." + sheet_name);
+        std::unique_ptr<IceRegridder> ice_regridder(new_ice_regridder(ncio, vn));
+
+        auto sheet_info_v = get_or_add_var(ncio, vn + ".info", "int", {});
+        get_or_put_att_enum(sheet_info_v, ncio.rw, "interp_style", ice_regridder->interp_style);
+
+        ice_regridder->gridA_proj_area.reference(marr->blitz_array<double,1>(
+            sheet_name + ".gridA_proj_area", MappedArrays::DOUBLE));
+
+        ice_regridder->agridI().ncio_meta(ncio, vn + ".agridI");
+        map_abbr_grid(ice_regridder->agridI(), marr, sheet_name + ".agridI");
+
+        auto &e(marr->entry(sheet_name + ".aexgrid.overlaps"));
+        ice_regridder->aexgrid().map(marr,
+            marr->data<int>(sheet_name + ".aexgrid.indices", MappedArrays::INT),
+            marr->data<double>(sheet_name + ".aexgrid.overlaps", MappedArrays::DOUBLE),
+            e.shape[0]);
+
+        gcm->add_sheet(sheet_name, std::move(ice_regridder));
+    }
+    ncio.close();
+
+    gcm->indexingE = derive_indexingE(gcm->agridA->indexing, gcm->indexingHC);
+    return gcm;
+}
+
+}    // namespace icebin
@@ -0,0 +1,169 @@
+/*
+ * IceBin: A Coupling Library for Ice Models and GCMs
+ * Copyright (c) 2013-2016 by Elizabeth Fischer
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <string>
+#include <cstdint>
+#include <blitz/array.h>
+#include <icebin/GCMRegridder.hpp>
+
+/** Memory-mapped GCMRegridder
+
+A GCMRegridder_Standard read the usual way (ncio()) holds a private
+copy of every AbbrGrid and ExchangeGrid.  When a pool of worker
+processes each opens the same regridder, memory use is multiplied by
+the number of workers.
+
+Here, the large immutable arrays (ijk, native_area, centroid_xy,
+gridA_proj_area, exchange grid overlaps) are stored in a flat binary
+file, which is mmap()ed read-only by each process.  The OS shares the
+pages among all processes mapping the file.  Placing the file in
+/dev/shm makes it a POSIX shared memory segment.  Small metadata
+(GridSpec, Indexing, hcdefs, etc.) is still read from the original
+NetCDF file.
+
+SparseSet dimensions are stored in the mapped file as well, but must be
+rebuilt in private memory because their lookup tables are hash maps.
+*/
+
+namespace icebin {
+
+/** Identifies the NetCDF regridder a mapped file was made from.  A
+mapped file is only reused if its recorded source matches. */
+struct MappedSource {
+    std::string fname;      // Absolute path of the NetCDF file
+    std::string vname;      // Name of the regridder inside it
+    int64_t size = -1;      // Size [bytes] of the NetCDF file
+    int64_t mtime = -1;     // Modification time of the NetCDF file
+
+    /** Describes nc_fname as it is now on disk. */
+    static MappedSource of(std::string const &nc_fname, std::string const &vname);
+
+    bool operator==(MappedSource const &other) const
+        { return fname == other.fname && vname == other.vname
+            && size == other.size && mtime == other.mtime; }
+};
+
+/** A flat file of named arrays, mapped read-only into memory. */
+class MappedArrays {
+public:
+    /** On-disk description of each array in the file */
+    struct Entry {
+        char name[80];
+        int32_t dtype;      // See DType
+        int32_t rank;
+        int64_t shape[2];
+        int64_t aux;        // Sparse extent, for SparseSet dims
+        int64_t offset;     // Bytes from beginning of file
+    };
+
+    enum DType { INT=0, LONG=1, DOUBLE=2 };
+
+    std::string const fname;
+
+    /** Source this file was made from, as recorded in its header */
+    MappedSource source;
+
+protected:
+    char const *base;
+    size_t len;
+    std::map<std::string, Entry const *> entries;
+
+public:
+    /** Maps the file read-only.  Checks that the header and every
+    array lie within the file. */
+    MappedArrays(std::string const &_fname);
+
+    /** Reads just the recorded source of a mapped file, without
+    mapping it.
+    @return false if the file does not exist or is not a (current
+        version) mapped file. */
+    static bool read_source(std::string const &fname, MappedSource &source);
+    ~MappedArrays();
+
+    Entry const &entry(std::string const &name) const;
+
+    bool has(std::string const &name) const
+        { return entries.find(name) != entries.end(); }
+
+    /** Pointer to the data of a named array; checks type. */
+    template<class T>
+    T const *data(std::string const &name, DType dtype) const
+    {
+        auto &e(entry(name));
+        if (e.dtype != dtype) (*icebin_error)(-1,
+            "Mapped array %s in %s has wrong type %d (expected %d)",
+            name.c_str(), fname.c_str(), e.dtype, dtype);
+        return reinterpret_cast<T const *>(base + e.offset);
+    }
+
+    /** Wraps a mapped array in a (read-only) blitz::Array.  The result
+    must not outlive this MappedArrays. */
+    template<class T, int RANK>
+    blitz::Array<T,RANK> blitz_array(std::string const &name, DType dtype) const;
+};
+
+template<class T, int RANK>
+blitz::Array<T,RANK> MappedArrays::blitz_array(std::string const &name, DType dtype) const
+{
+    auto &e(entry(name));
+    if (e.rank != RANK) (*icebin_error)(-1,
+        "Mapped array %s in %s has rank %d (expected %d)",
+        name.c_str(), fname.c_str(), e.rank, RANK);
+
+    blitz::TinyVector<int,RANK> shape;
+    long n = 1;
+    for (int i=0; i<RANK; ++i) {
+        shape[i] = e.shape[i];
+        n *= e.shape[i];
+    }
+    if (n == 0) return blitz::Array<T,RANK>();
+
+    // blitz::Array has no const version; the memory is mapped PROT_READ,
+    // so any attempt to write will fault.
+    return blitz::Array<T,RANK>(
+        const_cast<T *>(data<T>(name, dtype)), shape, blitz::neverDeleteData);
+}
+
+/** Writes the large arrays of gcm to a file suitable for MappedArrays.
+The file is written to a temporary name and then renamed, so processes
+racing to create it never see a partial file.
+@param source Recorded in the header; where gcm was read from */
+extern void write_mapped_arrays(
+    GCMRegridder_Standard const &gcm,
+    MappedSource const &source,
+    std::string const &mapped_fname);
+
+/** Loads a GCMRegridder_Standard whose large arrays live in a
+read-only shared mapping.  If mapped_fname does not yet exist, or was
+made from a different file, variable or version of nc_fname (by name,
+size and mtime), it is first (re)created from nc_fname.  Processes
+starting together take a lock (mapped_fname + ".lock"), so only the
+first one builds the file.
+@param nc_fname Regridder file, as written by GCMRegridder_Standard::ncio()
+@param vname Name of the regridder in nc_fname (eg: "m")
+@param mapped_fname File to map (eg: in /dev/shm) */
+extern std::unique_ptr<GCMRegridder_Standard> new_GCMRegridder_Mapped(
+    std::string const &nc_fname,
+    std::string const &vname,
+    std::string const &mapped_fname);
+
+}    // namespace icebin
@@ -20,6 +20,7 @@
 #include <algorithm>
 #include <icebin/Grid.hpp>
 #include <ibmisc/netcdf.hpp>
+#include <boost/filesystem.hpp>
 //#include <boost/bind.hpp>
 //#include <giss/constant.hpp>
 #include <icebin/error.hpp>
@@ -355,8 +356,33 @@ std::string const &vname)
     }
 }
 
+void write_grid_ref(NcIO &ncio, std::string const &vname,
+    std::string const &ref_fname, std::string const &ref_vname)
+{
+    auto ref_v = get_or_add_var(ncio, vname + ".ref", "int", {});
+    std::string fname(boost::filesystem::absolute(ref_fname).string());
+    std::string rvname(ref_vname);
+    get_or_put_att(ref_v, ncio.rw, "fname", fname);
+    get_or_put_att(ref_v, ncio.rw, "vname", rvname);
+}
+
 void Grid::ncio(NcIO &ncio, std::string const &vname, bool rw_full)
 {
+    // ------ Follow a reference to a grid in another file
+    if (ncio.rw == 'r' && ncio.nc->getVar(vname + ".info").isNull()
+        && !ncio.nc->getVar(vname + ".ref").isNull())
+    {
+        auto ref_v = get_or_add_var(ncio, vname + ".ref", "int", {});
+        std::string ref_fname, ref_vname;
+        get_or_put_att(ref_v, ncio.rw, "fname", ref_fname);
+        get_or_put_att(ref_v, ncio.rw, "vname", ref_vname);
+
+        NcIO ref_ncio(ref_fname, 'r');
+        this->ncio(ref_ncio, ref_vname, rw_full);
+        ref_ncio.close();
+        return;
+    }
+
     // ------ Do the spec first, then the boring long stuff later
     ncio_grid_spec(ncio, spec, vname);
 
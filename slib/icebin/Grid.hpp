@@ -303,6 +303,9 @@ protected:
     void nc_read(netCDF::NcGroup *nc, std::string const &vname);
     void nc_write(netCDF::NcGroup *nc, std::string const &vname) const;
 public:
+    /** Reads or writes the grid.  On read, if the file has a
+    reference <vname>.ref (see write_grid_ref()) instead of the grid
+    itself, the grid is read from the file it refers to. */
     virtual void ncio(ibmisc::NcIO &ncio, std::string const &vname, bool rw_full=true);
 
 
@@ -313,6 +316,14 @@ public:
 
 void sort_renumber_vertices(Grid &grid);
 
+/** Writes a reference to a grid stored in another file, in place of
+the grid itself.  Grid::ncio() follows it on read.
+@param vname Name the grid would have in this file (eg: "gridA")
+@param ref_fname File holding the grid (stored as an absolute path)
+@param ref_vname Name of the grid in ref_fname (eg: "grid") */
+void write_grid_ref(ibmisc::NcIO &ncio, std::string const &vname,
+    std::string const &ref_fname, std::string const &ref_vname);
+
 
 }   // namespace
 
@@ -97,21 +97,29 @@ GridSpec_LonLat make_grid_spec(HntrSpec const &hntr, bool pole_caps, int points_
     lonb.push_back(lonb[0] + 360.);
 
     // Latitude grid boundaries
-    latb.push_back(0);
-    double dlat_d = hntr.dlat / 60.;    // Convert minutes -> degrees
-    for (int j=1; j<hntr.jm/2; ++j) {
-        double lat = j * dlat_d;
-        latb.push_back(lat);
-        latb.push_back(-lat);
-    }
-    if (!pole_caps) {
-        double lat = hntr.jm/2 * dlat_d;
-        if (std::abs(lat-90.) < 1.e-10) lat = 90.;
-        latb.push_back(lat);
-        latb.push_back(-lat);
-    }
+    if (!hntr.uniform_lat()) {
+        latb = hntr.latb;
+        if (pole_caps) {
+            latb.pop_back();
+            latb.erase(latb.begin());
+        }
+    } else {
+        latb.push_back(0);
+        double dlat_d = hntr.dlat / 60.;    // Convert minutes -> degrees
+        for (int j=1; j<hntr.jm/2; ++j) {
+            double lat = j * dlat_d;
+            latb.push_back(lat);
+            latb.push_back(-lat);
+        }
+        if (!pole_caps) {
+            double lat = hntr.jm/2 * dlat_d;
+            if (std::abs(lat-90.) < 1.e-10) lat = 90.;
+            latb.push_back(lat);
+            latb.push_back(-lat);
+        }
 
-    std::sort(latb.begin(), latb.end());
+        std::sort(latb.begin(), latb.end());
+    }
 
     GridSpec_LonLat spec(
         std::move(lonb), std::move(latb),
@@ -130,6 +138,24 @@ HntrSpec::HntrSpec(int _im, int _jm, double _offi, double _dlat)
     if (dlat < .1 * (180.*60./jm)) (*icebin_error)(-1,
         "dlat in HntrGrid(%d,%d,%f,%f) seems to small; it should be in MINUTES ,not DEGREES: %f", im,jm,offi,dlat, .1 * (180.*60./jm));
 }
+
+HntrSpec::HntrSpec(int _im, double _offi, std::vector<double> &&_latb)
+    : im(_im), jm(_latb.size()-1), offi(_offi), latb(std::move(_latb))
+{
+    if (latb.size() < 2) (*icebin_error)(-1,
+        "HntrSpec needs at least 2 latitude boundaries");
+    if (latb.front() != -90. || latb.back() != 90.) (*icebin_error)(-1,
+        "HntrSpec latitude boundaries must run from -90 to 90 (vs. %f to %f)",
+        latb.front(), latb.back());
+    for (size_t j=1; j<latb.size(); ++j) {
+        if (latb[j] <= latb[j-1]) (*icebin_error)(-1,
+            "HntrSpec latitude boundaries must increase: latb[%ld]=%f, latb[%ld]=%f",
+            j-1, latb[j-1], j, latb[j]);
+    }
+
+    // Nominal value only, for code that prints the spec
+    dlat = 180.*60. / jm;
+}
 // -----------------------------------------------------
 void HntrSpec::ncio(ibmisc::NcIO &ncio, std::string const &vname)
 {
@@ -141,6 +167,16 @@ void HntrSpec::ncio(ibmisc::NcIO &ncio, std::string const &vname)
     get_or_put_att(hntr_v, ncio.rw, "jm", "int", &jm, 1);
     get_or_put_att(hntr_v, ncio.rw, "offi", "double", &offi, 1);
     get_or_put_att(hntr_v, ncio.rw, "dlat", "double", &dlat, 1);
+
+    // Non-uniform latitudes
+    bool has_latb = !latb.empty();
+    if (ncio.rw == 'r') {
+        auto atts(hntr_v.getAtts());
+        has_latb = (atts.find("latb") != atts.end());
+        latb.clear();
+        if (has_latb) latb.resize(jm+1);
+    }
+    if (has_latb) get_or_put_att(hntr_v, ncio.rw, "latb", "double", &latb[0], jm+1);
 }
 
 void GridSpec_LonLat::ncio(ibmisc::NcIO &ncio, std::string const &vname)
@@ -215,6 +251,11 @@ std::vector<double> HntrSpec::latc() const
 {
     std::vector<double> ret;
 
+    if (!uniform_lat()) {
+        for (int j=0; j<jm; ++j) ret.push_back(.5 * (latb[j] + latb[j+1]));
+        return ret;
+    }
+
     // Latitude grid boundaries
     double dlat_d = dlat / 60.;    // Convert minutes -> degrees
     for (int j=0; j<jm/2; ++j) {
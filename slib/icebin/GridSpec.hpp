@@ -1,6 +1,7 @@
 #ifndef ICEBIN_GRIDSPEC_HPP
 #define ICEBIN_GRIDSPEC_HPP
 
+#include <tuple>
 #include <boost/enum.hpp>
 #include <ibmisc/netcdf.hpp>
 #include <icebin/error.hpp>
@@ -151,11 +152,29 @@ struct HntrSpec {
     // minutes of latitude for non-polar cells on grid A
     double dlat;
 
+    // Latitude of cell boundaries (degrees), south to north: jm+1
+    // values from -90 to 90.  Empty for the usual uniform grids;
+    // if set (Gaussian, stretched, etc. grids), dlat is only nominal.
+    std::vector<double> latb;
+
     void ncio(ibmisc::NcIO &ncio, std::string const &vname);
 
     HntrSpec() : im(-1), jm(-1), offi(0.), dlat(0.) {}
     HntrSpec(int _im, int _jm, double _offi, double _dlat);
 
+    /** Grid with non-uniform latitudes.
+    @param _latb Latitude of cell boundaries (degrees); see latb. */
+    HntrSpec(int _im, double _offi, std::vector<double> &&_latb);
+
+    bool uniform_lat() const { return latb.empty(); }
+
+    /** Ordering, so specs can be used as keys (eg: hntr_plan()) */
+    bool operator<(HntrSpec const &other) const
+    {
+        return std::tie(im, jm, offi, dlat, latb)
+            < std::tie(other.im, other.jm, other.offi, other.dlat, other.latb);
+    }
+
     int size() const { return im*jm; }
     int ndata() const { return size(); }    // Convention makes this more like regular ModelE grids
 
@@ -18,6 +18,8 @@
 
 #include <mpi.h>        // Intel MPI wants to be first
 #include <type_traits>
+#include <algorithm>
+#include <cmath>
 #include <boost/filesystem.hpp>
 
 #include <spsparse/blitz.hpp>
@@ -118,7 +120,14 @@ void IceCoupler::ncio_icebin_rsf(ibmisc::NcIO &ncio)
     // The first time this is called to write will be before that time.
     // In that case, dimE0 and IvE0 will not yet bet set.
 
-    if (ncio.rw == 'r') dimE0.reset(new SparseSetT);
+    // Writes are deferred until the NcIO is closed, so IvE0 must stay
+    // decompressed from here on (it is stashed again next timestep).
+    unstash(IvE0, IvE0_z);
+
+    if (ncio.rw == 'r') {
+        dimE0.reset(new SparseSetT);
+        dimE0_frozen.reset();
+    }
     if (dimE0.get() != nullptr) dimE0->ncio(ncio, "IceCoupler."+name()+".dimE0");
 
     if (ncio.rw == 'r') IvE0.reset(new EigenSparseMatrixT);
@@ -201,6 +210,7 @@ printf("wB_b-%d = %f\n", wB_b(i));
 #endif
 // -----------------------------------------------------------
 blitz::Array<double,2> IceCoupler::construct_ice_ivalsI(
+double time_s,
 blitz::Array<double,2> const &gcm_ovalsE0,
 std::vector<std::pair<std::string, double>> const &scalars,
 double dt,
@@ -232,10 +242,17 @@ printf("BEGIN construct_ice_ivalsI(dt=%g)\n", dt);
         const_cast<double *>(gcm_ovalsE0.data()),
         gcm_ovalsE0.extent(1), gcm_ovalsE0.extent(0));
 
+    unstash(IvE0, IvE0_z);
+
     // Ice inputs calculated as the result of a matrix multiplication
     // ice_ivalsI_e is |i| x |k|
-    ice_ivalsI_e = (*IvE0) * (
-        gcm_ovalsE0_e * icei_v_gcmo_T.M + icei_v_gcmo_T.b.replicate(nE0,1) );
+    EigenDenseMatrixT const ice_ivalsE0_e(
+        gcm_ovalsE0_e * icei_v_gcmo_T.M + icei_v_gcmo_T.b.replicate(nE0,1));
+    ice_ivalsI_e = (*IvE0) * ice_ivalsE0_e;
+
+    if (auditor && wI_audit.size() > 0 && wE0_audit.size() >= nE0)
+        auditor->audit(time_s, "IvE",
+            contract[INPUT], wE0_audit, ice_ivalsE0_e, wI_audit, ice_ivalsI_e);
 
     // Alias the Eigen matrix to blitz array
     blitz::Array<double,2> ice_ivalsI(
@@ -251,6 +268,41 @@ printf("END construct_ice_ivalsI()\n");
     return ice_ivalsI;
 }
 // -----------------------------------------------------------
+void IceCoupler::set_audit_weights(RegridMatrices_Dynamic &rm, SparseSetT const &dimE1)
+{
+    // I: True cell areas, masked the same way as the matrices.
+    // Only L0 grids have an area per I cell.
+    AbbrGrid const &agridI(ice_regridder->agridI());
+    if (agridI.parameterization != GridParameterization::L0) {
+        wI_audit.free();
+        return;
+    }
+    wI_audit.reference(blitz::Array<double,1>(nI()));
+    wI_audit = 0;
+    for (int id=0; id < agridI.dim.dense_extent(); ++id) {
+        auto iI(agridI.dim.to_sparse(id));
+        if (!std::isnan(emI_ice(iI))) wI_audit(iI) = agridI.native_area(id);
+    }
+
+    // E: Projected areas, from the rows of EvI (not IvE)
+    blitz::Array<double,1> const &wE(E1vI_unscaled_nc->wM);
+    wE0_audit.reference(blitz::Array<double,1>(dimE1.dense_extent()));
+    wE0_audit = 0;
+    for (int jj=0; jj < wE.extent(0); ++jj) wE0_audit(jj) = wE(jj);
+
+    // A: A1vI_unscaled is weighted by native area.  Build it again
+    // without the correction to get each cell's projected / native
+    // area.  rdimA1 already holds every A cell, so dense indices match.
+    auto A1vI_nc(rm.matrix_d("AvI", {&*rdimA1, &*rdimI},
+        RegridParams(false, false, {0,0,0})));    // scale=f, correctA=f
+    blitz::Array<double,1> const &wA(A1vI_unscaled->wM);
+    wA1_audit.reference(blitz::Array<double,1>(rdimA1->dense_extent()));
+    wA1_audit = 0;
+    for (int jj=0; jj < wA.extent(0); ++jj) {
+        if (wA(jj) != 0) wA1_audit(jj) = A1vI_nc->wM(jj) / wA(jj);
+    }
+}
+// -----------------------------------------------------------
 /** 
 @param do_run True if we are to actually run (otherwise just return ice_ovalsI from current state)
 @param gcm_ivalsAE_s Contract inputs for the GCM on the A nad E grid, respectively (1D indexing).
@@ -283,6 +335,11 @@ bool run_ice)
 
     printf("BEGIN IceCoupler::couple(%s)\n", name().c_str());
 
+    if (gcm_coupler->gcm_params.audit_conservation && !auditor) {
+        auditor.reset(new ConservationAuditor(
+            (boost::filesystem::path(output_dir) / "budget.txt").string()));
+    }
+
     // ========== Get Ice Inputs
     // E_s = Elevation grid (sparse indices)
     // E0 = Elevation grid @ beginning of timestep (dense indices)
@@ -297,17 +354,20 @@ bool run_ice)
             long iE_s(gcm_ovalsE_s.index[i]);
             dimE0->add_dense(iE_s);
         }
+        dimE0_frozen.reset();
     }
+    if (!dimE0_frozen) dimE0_frozen.reset(new FrozenSparseSetT(*dimE0));
+    FrozenSparseSetT const &dimE0f(*dimE0_frozen);
 
     // ------------- Create gcm_ovalsE
     // Densify gcm_ovalsE_s --> gcm_ovalsE
     // This should ONLY involve iE already mentioned in IvE0;
-    // if not, ibmisc_error() will be called inside to_dense()
+    // if not, icebin_error() will be called inside to_dense()
     blitz::Array<double,2> gcm_ovalsE(gcm_coupler->gcm_outputsE.size(), dimE0->dense_extent());
     gcm_ovalsE = 0;
     for (size_t i=0; i<gcm_ovalsE_s.size(); ++i) {
         long iE_s(gcm_ovalsE_s.index[i]);
-        int iE0(dimE0->to_dense(iE_s));   // Can raise error if iE_s not found
+        int iE0(dimE0f.to_dense(iE_s));   // Can raise error if iE_s not found
         for (int ivar=0; ivar<gcm_ovalsE_s.nvar; ++ivar) {
             gcm_ovalsE(ivar, iE0) += gcm_ovalsE_s.val(ivar, i);
         }
@@ -325,7 +385,7 @@ bool run_ice)
     {
         TmpAlloc tmp;    // Allocate variables for the duration of this function
         blitz::Array<double,2> ice_ivalsI(run_ice ?
-            construct_ice_ivalsI(gcm_ovalsE, scalars, dt, tmp) :
+            construct_ice_ivalsI(time_s, gcm_ovalsE, scalars, dt, tmp) :
             blitz::Array<double,2>(contract[INPUT].size(), nI()));
 
         // ========= Step the ice model forward
@@ -354,28 +414,72 @@ bool run_ice)
     if (&ice_ovalsI(emI_land_ix,0) != &out_emI_land(0)) (*icebin_error)(-1,
         "ice_ovalsI <%p> != emI_land <%p>\n", &ice_ovalsI(emI_land_ix,0), &out_emI_land(0));
 
-    emI_ice = out_emI_ice;    // Copy
-    emI_land = out_emI_land;    // Copy
     GCMRegridder *gcmr(&*gcm_coupler->gcm_regridder);
     int sheet_index = gcmr->ice_regridders().index.at(name());
-    std::unique_ptr<RegridMatrices_Dynamic> rm(gcmr->regrid_matrices(sheet_index, emI_ice));
 
-    // ------ Update E1vE0 translation between old and new elevation classes
-    //        (global for all ice sheets)
-    // A SparseSet that is identity for the entire range of I
-    SparseSetT dimI(id_sparse_set<SparseSetT>(nI()));
+    // ------ Decide whether the regrid matrices need to be rebuilt.
+    // Changes are measured against the elevmasks the current matrices
+    // were built from, so skipped steps do not accumulate error.
+    GCMParams const &gcm_params(gcm_coupler->gcm_params);
+    regrids_rebuilt = true;
+    elevmask_drift = ElevmaskChange();
+    if (run_ice && XuE1 && gcm_params.rebuild_max_delev >= 0) {
+        // With per-cell elevation classes, count crossings of any
+        // cell's class boundaries (conservative).
+        std::vector<double> hcdefs(gcmr->hcdefs());
+        if (gcmr->hcdefsA_values.size() > 0) {
+            hcdefs = gcmr->hcdefsA_values;
+            std::sort(hcdefs.begin(), hcdefs.end());
+            hcdefs.erase(std::unique(hcdefs.begin(), hcdefs.end()), hcdefs.end());
+        }
+        ElevmaskChange const change(elevmask_change(
+            emI_ice, emI_land, out_emI_ice, out_emI_land, hcdefs));
+        regrids_rebuilt = !(change.max_delev <= gcm_params.rebuild_max_delev
+            && change.ncross <= gcm_params.rebuild_max_ncross);
+        if (!regrids_rebuilt) elevmask_drift = change;
+        printf("IceCoupler::couple(%s): max_delev=%g (tol %g), ncross=%ld (tol %ld): %s regrid matrices\n",
+            name().c_str(),
+            change.max_delev, gcm_params.rebuild_max_delev,
+            change.ncross, gcm_params.rebuild_max_ncross,
+            regrids_rebuilt ? "rebuilding" : "reusing");
+    }
 
-    // _nc means "No Correct" for changes in area due to projections
-    // See commit d038e5cb for deeper explanation
-    std::unique_ptr<SparseSetT> dimE1(new SparseSetT(gcmr->nE()));
-    auto E1vI_unscaled_nc(rm->matrix_d("EvI", {&*dimE1, &dimI},
-        RegridParams(false, false, {0,0,0})));    // scale=f, correctA=f
+    std::unique_ptr<SparseSetT> dimE1;
+    std::unique_ptr<EigenSparseMatrixT> IvE1;
+    if (regrids_rebuilt) {
+        emI_ice = out_emI_ice;    // Copy
+        emI_land = out_emI_land;    // Copy
+        std::unique_ptr<RegridMatrices_Dynamic> rm(gcmr->regrid_matrices(sheet_index, emI_ice));
+
+        // ------ Update E1vE0 translation between old and new elevation classes
+        //        (global for all ice sheets)
+        // A SparseSet that is identity for the entire range of I
+        rdimI.reset(new SparseSetT(id_sparse_set<SparseSetT>(nI())));
+
+        // _nc means "No Correct" for changes in area due to projections
+        // See commit d038e5cb for deeper explanation
+        dimE1.reset(new SparseSetT(gcmr->nE()));
+        E1vI_unscaled_nc = rm->matrix_d("EvI", {&*dimE1, &*rdimI},
+            RegridParams(false, false, {0,0,0}));    // scale=f, correctA=f
+
+        rdimA1.reset(new SparseSetT);
+        A1vI_unscaled = rm->matrix_d("AvI", {&*rdimA1, &*rdimI},
+            RegridParams(false, true, {0,0,0}));    // scale=f, correctA=t
+
+        // Compute IvE (for use interpreting stuffE at beginning of next timestep)
+        auto IvE1_w(rm->matrix_d("IvE", {&*rdimI, &*dimE1},
+            RegridParams(true, true, sigma))); // scale=t, correctA=t
+        IvE1 = std::move(IvE1_w->M);
+
+        if (gcm_params.audit_conservation) set_audit_weights(*rm, *dimE1);
+
+        // Compute XuE
+        rdimX.reset(new SparseSetT(id_sparse_set<SparseSetT>(ice_regridder->nX())));
+        XuE1 = rm->matrix_d("XvE", {&*rdimX, &*dimE1},
+            RegridParams(false, true, std::array<double,3>{0,0,0}));
+    }
 
     // ========= Compute gcm_ivalsE
-    SparseSetT dimA1;
-    auto A1vI_unscaled(rm->matrix_d("AvI", {&dimA1, &dimI},
-        RegridParams(false, true, {0,0,0})));    // scale=f, correctA=t
-
     // Do it once for _E variables and once for _A variables.
     std::vector<linear::Weighted_Eigen *> AE1vIs(gcm_ivalss_s.size());
         AE1vIs[(int)IndexAE::A] = &*A1vI_unscaled;
@@ -442,8 +546,17 @@ bool run_ice)
 
         // Regrid while recombining variables
         // (Do not need to use Weighted_Eigen::apply(), since this is not IvE)
-        EigenDenseMatrixT gcm_ivalsX((*AE1vIs[iAE]->M) * (
-            ice_ovalsI_e * gcmi_v_iceo_T.M + gcmi_v_iceo_T.b.replicate(nI(),1) ));
+        EigenDenseMatrixT const gcm_ivalsI(
+            ice_ovalsI_e * gcmi_v_iceo_T.M + gcmi_v_iceo_T.b.replicate(nI(),1));
+        EigenDenseMatrixT gcm_ivalsX((*AE1vIs[iAE]->M) * gcm_ivalsI);
+
+        // Matrix is unscaled, so gcm_ivalsX is already weighted
+        // (by projected area for E, native area for A)
+        if (auditor && wI_audit.size() > 0) auditor->audit(time_s,
+            (iAE == (int)IndexAE::A ? "AvI" : "EvI"),
+            gcm_coupler->gcm_inputs[iAE], wI_audit, gcm_ivalsI,
+            (iAE == (int)IndexAE::A ? wA1_audit : blitz::Array<double,1>()),
+            gcm_ivalsX);
         // Sparsify while appending to the global VectorMultivec
         // (Transposes order in memory)
         std::vector<double> vals(gcm_ivalss_s[iAE].nvar);
@@ -457,17 +570,16 @@ bool run_ice)
 
         }
     }        // iAE
-    // Compute IvE (for use interpreting stuffE at beginning of next timestep)
-    std::unique_ptr<EigenSparseMatrixT> IvE1(
-        std::move(rm->matrix_d("IvE", {&dimI, &*dimE1},
-        RegridParams(true, true, sigma))->M)); // scale=t, correctA=t
-
-    // Compute XuE
-    SparseSetT dimX(id_sparse_set<SparseSetT>(ice_regridder->nX()));
-    ret.XuE = rm->matrix_d("XvE", {&dimX, &*dimE1},
-        RegridParams(false, true, std::array<double,3>{0,0,0}));
-    ret.dimE = &*dimE1;   // reference, not moving it
+    if (!regrids_rebuilt) {
+        // Matrices are unchanged; dimE0 and IvE0 remain valid
+        ret.XuE = &*XuE1;
+        ret.dimE = &*dimE0;
+        printf("END IceCoupler::couple(%s)\n", name().c_str());
+        return ret;
+    }
 
+    ret.XuE = &*XuE1;
+    ret.dimE = &*dimE1;   // reference, not moving it
 
     // Record our matrices for posterity
     {auto fname(
@@ -476,26 +588,67 @@ bool run_ice)
     NcIO ncio(fname.string(), NcFile::replace);
 
         // Write matrices as their dense subspace versions, not the sparsified versions.
-        dimI.ncio(ncio, "dimI");
-        dimX.ncio(ncio, "dimX");
-        dimA1.ncio(ncio, "dimA");
+        rdimI->ncio(ncio, "dimI");
+        rdimX->ncio(ncio, "dimX");
+        rdimA1->ncio(ncio, "dimA");
         dimE1->ncio(ncio, "dimE");
 
         AE1vIs[GridAE::E]->ncio(ncio, "EuI_nc", {"dimE", "dimI"});
         AE1vIs[GridAE::A]->ncio(ncio, "AuI", {"dimA", "dimI"});
         ncio_eigen(ncio, *IvE1, "IvE");
-        ret.XuE->ncio(ncio, "XuE", {"dimX", "dimE"});
+        XuE1->ncio(ncio, "XuE", {"dimX", "dimE"});
     }
 
     // ---------- Save stuff for next time around
     // Store stuff from this timestep for next time around
+    // (Moving the unique_ptr leaves the matrices' pointers to *dimE1 valid)
     this->dimE0 = std::move(dimE1);
+    this->dimE0_frozen.reset();
     this->IvE0 = std::move(IvE1);
 
     printf("END IceCoupler::couple(%s)\n", name().c_str());
     return ret;
 }
 
+// =======================================================
+ElevmaskChange elevmask_change(
+    blitz::Array<double,1> const &emI_ice0,
+    blitz::Array<double,1> const &emI_land0,
+    blitz::Array<double,1> const &emI_ice1,
+    blitz::Array<double,1> const &emI_land1,
+    std::vector<double> const &hcdefs)
+{
+    ElevmaskChange ret;
+    for (int iI=0; iI<emI_ice1.extent(0); ++iI) {
+        double const ice0 = emI_ice0(iI);
+        double const ice1 = emI_ice1(iI);
+        double const land0 = emI_land0(iI);
+        double const land1 = emI_land1(iI);
+
+        // Cells entering or leaving the ice or land mask
+        if (std::isnan(ice0) != std::isnan(ice1)
+            || std::isnan(land0) != std::isnan(land1))
+        {
+            ++ret.ncross;
+            continue;
+        }
+
+        // Elevation changes of ice AND bare land cells: TOPO fields
+        // (eg ZATMO) are computed from both.
+        if (!std::isnan(land1))
+            ret.max_delev = std::max(ret.max_delev, std::abs(land1 - land0));
+        if (std::isnan(ice1)) continue;
+
+        ret.max_delev = std::max(ret.max_delev, std::abs(ice1 - ice0));
+
+        // Cells moving into a different elevation class
+        auto const ec0(std::upper_bound(hcdefs.begin(), hcdefs.end(), ice0));
+        auto const ec1(std::upper_bound(hcdefs.begin(), hcdefs.end(), ice1));
+        if (ec0 != ec1) ++ret.ncross;
+    }
+    return ret;
+}
+
 // =======================================================
 /** Specialized init signature for IceWriter */
 IceWriter::IceWriter(
@@ -506,7 +659,7 @@ IceWriter::IceWriter(
 {
     printf("BEGIN IceWriter::init(%s)\n", fname.c_str());
 
-    ibmisc::Indexing const &indexing(ice_coupler->ice_regridder->agridI.indexing);
+    ibmisc::Indexing const &indexing(ice_coupler->ice_regridder->agridI().indexing);
 
     file_initialized = false;
 
@@ -11,6 +11,9 @@
 #include <icebin/GCMRegridder.hpp>
 #include <icebin/VarSet.hpp>
 #include <icebin/multivec.hpp>
+#include <icebin/audit.hpp>
+#include <icebin/zeigen.hpp>
+#include <icebin/frozen_sparse_set.hpp>
 
 namespace ibmisc {
     class NcIO;
@@ -22,6 +25,16 @@ class GCMCoupler;
 class GCMInput;    // formerly GCMCouplerOutput
 class IceWriter;
 
+/** How much an ice sheet's elevmasks have changed between two couplings */
+struct ElevmaskChange {
+    /** Largest change in elevation [m] among ice grid cells that are
+    in the ice or land mask both before and after */
+    double max_delev = 0;
+    /** Number of ice grid cells that entered or left the ice or land
+    mask, or moved into a different elevation class */
+    long ncross = 0;
+};
+
 class IceCoupler {
     friend class IceWriter;
 
@@ -59,6 +72,24 @@ public:
     // Used to interpret GCM output
     std::unique_ptr<EigenSparseMatrixT> IvE0;   // SCALED
     std::unique_ptr<SparseSetT> dimE0;
+    // Lookup table for *dimE0; rebuilt on first use after dimE0 changes
+    std::unique_ptr<FrozenSparseSetT> dimE0_frozen;
+    // IvE0, while stashed between coupling steps
+    // (if GCMParams::compress_held_matrices)
+    ZEigenSparse IvE0_z;
+    // Weights used only for auditing; set when the regrid matrices
+    // are rebuilt.  They come from the grids (or a differently built
+    // matrix), not from the matrix being audited, so an audit can
+    // fail.  Not saved in restart files.
+    //   wI_audit: True area of each I cell in the ice mask; 0 elsewhere
+    //   wE0_audit: Projected area of each dimE0 cell (rows of EvI)
+    //   wA1_audit: Projected / native area of each rdimA1 cell
+    //              (undoes the area correction in A1vI_unscaled)
+    blitz::Array<double,1> wI_audit, wE0_audit, wA1_audit;
+
+    // Conservation budgets for this ice sheet
+    // (if GCMParams::audit_conservation)
+    std::unique_ptr<ConservationAuditor> auditor;
 
     // Output of ice model from the last time we coupled.
     // Some of these values are needed for computation of ice_ivalsI
@@ -86,11 +117,30 @@ public:
     std::array<std::unique_ptr<IceWriter>, 2> writer;
 
     // Current ice sheet elevation
+    // (as of the last time the regrid matrices were built)
     blitz::Array<double,1> emI_ice, emI_land;
+
+    // Regrid matrices built from emI_ice.  They are reused as long as
+    // the ice model's elevations stay within the tolerances in
+    // GCMParams (rebuild_max_delev, rebuild_max_ncross).
+    // Dimension E for these is *dimE0.
+    std::unique_ptr<SparseSetT> rdimI, rdimA1, rdimX;
+    std::unique_ptr<ibmisc::linear::Weighted_Eigen> E1vI_unscaled_nc;
+    std::unique_ptr<ibmisc::linear::Weighted_Eigen> A1vI_unscaled;
+    std::unique_ptr<ibmisc::linear::Weighted_Eigen> XuE1;
+
+public:
+    /** Were the regrid matrices rebuilt on the last call to couple()? */
+    bool regrids_rebuilt = false;
+
+    /** If the regrid matrices (and TOPO) were reused on the last call
+    to couple(): how far the ice model's elevmasks had drifted from
+    those they were built from.  Zero after a rebuild. */
+    ElevmaskChange elevmask_drift;
 public:
     std::string const &name() const { return _name; }
-    AbbrGrid const &agridI() { return ice_regridder->agridI; }
-    long nI() const { return ice_regridder->agridI.dim.sparse_extent(); }
+    AbbrGrid const &agridI() { return ice_regridder->agridI(); }
+    long nI() const { return ice_regridder->agridI().dim.sparse_extent(); }
 
     // ======================================================
 
@@ -153,19 +203,27 @@ protected:
     input using general means.  This function is customized by
     setting reconstruct_ice_ivalsI below. */
     blitz::Array<double,2> construct_ice_ivalsI(
+        double time_s,
         blitz::Array<double,2> const &gcm_ovalsE0,
         std::vector<std::pair<std::string, double>> const &scalars,
         double dt,
         ibmisc::TmpAlloc &tmp);
 
+    /** Sets wI_audit, wE0_audit and wA1_audit for freshly built
+    E1vI_unscaled_nc and A1vI_unscaled (built from emI_ice).
+    @param rm Regrid matrices from which they were built
+    @param dimE1 E dimension of E1vI_unscaled_nc */
+    void set_audit_weights(RegridMatrices_Dynamic &rm, SparseSetT const &dimE1);
+
 public:
     /** A "virtual function" used to customize construct_ice_ivalsI().
     This defaults to NOP, and is set by the coupling contract. */
     std::function<void(blitz::Array<double,2> &, double)> reconstruct_ice_ivalsI;
 
     struct CoupleOut {
-        /** X=exchange grid; E=elevation grid; XuE used to compute E1vE0 */
-        std::unique_ptr<ibmisc::linear::Weighted_Eigen> XuE;    // UNSCALED
+        /** X=exchange grid; E=elevation grid; XuE used to compute E1vE0
+        (owned by the IceCoupler) */
+        ibmisc::linear::Weighted_Eigen const *XuE;    // UNSCALED
         SparseSetT *dimE;   // Used to interpret XuE
     };
 
@@ -194,6 +252,16 @@ public:
 };      // class IceCoupler
 // =========================================================
 
+/** Compares two sets of elevmasks in a single pass.
+@param hcdefs Elevation class definitions, used to detect cells
+    that change elevation class. */
+extern ElevmaskChange elevmask_change(
+    blitz::Array<double,1> const &emI_ice0,
+    blitz::Array<double,1> const &emI_land0,
+    blitz::Array<double,1> const &emI_ice1,
+    blitz::Array<double,1> const &emI_land1,
+    std::vector<double> const &hcdefs);
+
 extern
 std::unique_ptr<IceCoupler> new_ice_coupler(ibmisc::NcIO &ncio,
     std::string const &vname, std::string const &sheet_name,
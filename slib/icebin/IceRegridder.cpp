@@ -1,6 +1,7 @@
 #include <cstdio>
 #include <iostream>
 #include <functional>
+#include <mutex>
 #include <icebin/GCMRegridder.hpp>
 #include <icebin/IceRegridder_L0.hpp>
 #include <icebin/Grid.hpp>
@@ -17,7 +18,7 @@ namespace icebin {
 static double const nan = std::numeric_limits<double>::quiet_NaN();
 
 // -----------------------------------------------------
-IceRegridder::IceRegridder() : interp_style(InterpStyle::Z_INTERP), _name("icesheet") {}
+IceRegridder::IceRegridder() : interp_style(InterpStyle::Z_INTERP), _name("icesheet"), _loaded(true) {}
 
 IceRegridder::~IceRegridder() {}
 
@@ -72,12 +73,38 @@ void IceRegridder::clear()
 }
 #endif
 // -------------------------------------------------------------
+/** Serializes lazy loads across all sheets (and all regridders) in
+the process: the NetCDF library is not thread-safe, so two sheets
+must not read at the same time either. */
+static std::mutex lazy_load_mutex;
+
+void IceRegridder::ncio_grids(NcIO &ncio, std::string const &vname)
+{
+    _agridI.ncio(ncio, vname + ".agridI");
+    _aexgrid.ncio(ncio, vname + ".aexgrid");
+}
+
+void IceRegridder::_load() const
+{
+    std::lock_guard<std::mutex> lock(lazy_load_mutex);
+    if (_loaded) return;    // Another thread got here first
+
+    printf("IceRegridder: loading sheet %s from %s\n",
+        _name.c_str(), _lazy_fname.c_str());
+
+    // Filling in the grids does not change the sheet's logical value
+    auto *self(const_cast<IceRegridder *>(this));
+    NcIO ncio(_lazy_fname, 'r');
+    self->ncio_grids(ncio, _lazy_vname);
+    ncio.close();
+
+    _loaded = true;
+}
+
 void IceRegridder::ncio(NcIO &ncio, std::string const &vname)
 {
-    if (ncio.rw == 'r') {
-        agridI.ncio(ncio, vname + ".agridI");
-        aexgrid.ncio(ncio, vname + ".aexgrid");
-    }
+    // Can't write what we haven't read
+    if (ncio.rw == 'w') load();
 
     auto info_v = get_or_add_var(ncio, vname + ".info", "int", {});
     get_or_put_att(info_v, ncio.rw, "name", _name);
@@ -85,31 +112,36 @@ void IceRegridder::ncio(NcIO &ncio, std::string const &vname)
 
     ncio_blitz_alloc(ncio, gridA_proj_area, vname + ".gridA_proj_area", "double",
         get_or_add_dims(ncio, gridA_proj_area, {"agridA.ndata"}));
-    agridI.ncio(ncio, vname + ".agridI");
-    aexgrid.ncio(ncio, vname + ".aexgrid");
 
+    if (ncio.rw == 'r' && _lazy_fname != "") {
+        // Leave the grids for load(), on first use
+        _lazy_vname = vname;
+        _loaded = false;
+    } else {
+        ncio_grids(ncio, vname);
+    }
 }
 
 void IceRegridder::init(
     std::string const &name,
     AbbrGrid const &agridA,
     Grid const *fgridA,        // Can be nil I grid is spherical
-    AbbrGrid const &&_agridI,
-    ExchangeGrid const &&_aexgrid,
+    AbbrGrid const &&agridI,
+    ExchangeGrid const &&aexgrid,
     InterpStyle _interp_style)
 {
-    agridI = std::move(_agridI);    // convert Grid -> AbbrGrid
-    aexgrid = std::move(_aexgrid);  // convert Grid -> AbbrGrid
-    _name = (name != "" ? name : agridI.name);
+    _agridI = std::move(agridI);    // convert Grid -> AbbrGrid
+    _aexgrid = std::move(aexgrid);  // convert Grid -> AbbrGrid
+    _name = (name != "" ? name : _agridI.name);
     interp_style = _interp_style;
 
-    if (agridI.sproj == "") {
+    if (_agridI.sproj == "") {
         // No projection; projected and unproject area are the same
         gridA_proj_area.reference(agridA.native_area);
     } else {
         // Use a projection
         gridA_proj_area.reference(blitz::Array<double,1>(agridA.dim.dense_extent()));
-        ibmisc::Proj_LL2XY proj(agridI.sproj);
+        ibmisc::Proj_LL2XY proj(_agridI.sproj);
         for (auto cell=fgridA->cells.begin(); cell != fgridA->cells.end(); ++cell) {
             int const is = cell->index;    // sparse index
             int const id = agridA.dim.to_dense(is);
@@ -149,6 +181,7 @@ static bool in_good(std::unordered_set<long> const *set, long index_c)
 
 void IceRegridder::filter_cellsA(std::function<bool (long)> const &useA)
 {
+    load();
 
   // Figure out which cells to keep
 
@@ -158,23 +191,23 @@ void IceRegridder::filter_cellsA(std::function<bool (long)> const &useA)
 
 
     std::unordered_set<int> good_j;
-    for (int id=0; id<aexgrid.dense_extent(); ++id) {
-        auto const is = aexgrid.to_sparse(id);
+    for (int id=0; id<_aexgrid.dense_extent(); ++id) {
+        auto const is = _aexgrid.to_sparse(id);
         if (useA(is)) {
-            good_index_gridI.insert(aexgrid.ijk(id,1));    // j
+            good_index_gridI.insert(_aexgrid.ijk(id,1));    // j
             good_index_exgrid.insert(is);
         }
     }
 
     // Remove unneeded cells from gridI
-    agridI.filter_cells(std::bind(&in_good, &good_index_gridI, _1));
+    _agridI.filter_cells(std::bind(&in_good, &good_index_gridI, _1));
 
     /** NOTE: This will result in ExchangeGrid cells being renumbered,
     resulting in different numbering schemes for different processors.
     That is not a problem because matrices based on this grid are only
     used temporarily; and this dimension is ultimately multiplied away
     before being shared between processors or in time. */
-    aexgrid.filter_cellsB(useA);
+    _aexgrid.filter_cellsB(useA);
 }
 // ================================================================
 // ==============================================================
@@ -20,6 +20,7 @@
 #define ICEBIN_ICEREGRIDDER_H
 
 #include <unordered_set>
+#include <atomic>
 #include <ibmisc/netcdf.hpp>
 
 #include <icebin/AbbrGrid.hpp>
@@ -65,15 +66,46 @@ protected:
     Type type;          /// GridParameterization
     std::string _name;  /// "greenland", "antarctica", etc.
 
+    AbbrGrid _agridI;           /// Ice grid outlines
+    ExchangeGrid _aexgrid;      /// Exchange grid overlaps (between GCM and Ice)
+
+    // ----- Lazy loading (see GCMRegridder_Standard::ncread_lazy())
+    /** File and variable prefix to read _agridI and _aexgrid from,
+    if they have not been read yet. */
+    std::string _lazy_fname;
+    std::string _lazy_vname;
+    mutable std::atomic<bool> _loaded;
+
+    /** Reads _agridI and _aexgrid from _lazy_fname, if not yet loaded.
+    Safe to call from multiple threads. */
+    void load() const
+        { if (!_loaded) _load(); }
+    void _load() const;
+
+    /** Reads/writes just _agridI and _aexgrid */
+    void ncio_grids(ibmisc::NcIO &ncio, std::string const &vname);
+
 public:
-    AbbrGrid agridI;            /// Ice grid outlines
-    ExchangeGrid aexgrid;       /// Exchange grid overlaps (between GCM and Ice)
     InterpStyle interp_style;   /// How we interpolate I<-E.  Determines basis functions in E
 
+    /** Ice grid outlines.  Loaded on first use if this sheet was
+    read with GCMRegridder_Standard::ncread_lazy(). */
+    AbbrGrid &agridI() { load(); return _agridI; }
+    AbbrGrid const &agridI() const { load(); return _agridI; }
+
+    /** Exchange grid overlaps (between GCM and Ice).  Loaded on first
+    use, like agridI(). */
+    ExchangeGrid &aexgrid() { load(); return _aexgrid; }
+    ExchangeGrid const &aexgrid() const { load(); return _aexgrid; }
+
+    /** True if agridI and aexgrid are in memory */
+    bool loaded() const { return _loaded; }
+
     // ---------------------------------
 
     // MatrixFunctions used by corresponding functions in GCMRegridder
-    /** Remove unnecessary GCM grid cells. */
+    /** Remove unnecessary GCM grid cells.  Loads the grids first, if
+    they were not loaded. */
     void filter_cellsA(std::function<bool(long)> const &keepA);
 
 public:
@@ -86,8 +118,8 @@ public:
         std::string const &_name,
         AbbrGrid const &agridA,
         Grid const *fgridA,  // Only required if agridI uses a projection
-        AbbrGrid const &&_agridI,
-        ExchangeGrid const &&_aexgrid,
+        AbbrGrid const &&agridI,
+        ExchangeGrid const &&aexgrid,
         InterpStyle _interp_style);
 
     // ------------------------------------------------
@@ -133,6 +165,8 @@ public:
         blitz::Array<double,1> const *elevmaskI) const = 0;
 
     /** Define, read or write this data structure inside a NetCDF file.
+    When reading for GCMRegridder_Standard::ncread_lazy(), only the
+    per-sheet metadata is read; agridI and aexgrid are left for load().
     @param vname: Variable name (or prefix) to define/read/write it under. */
     virtual void ncio(ibmisc::NcIO &ncio, std::string const &vname);
 
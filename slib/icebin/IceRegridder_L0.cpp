@@ -41,7 +41,7 @@ size_t IceRegridder_L0::nG(char gridG) const
 elevation class boundaries midway between height points.
 @return Index of point in xpoints[] array that is closes to xx. */
 static int nearest_1d(
-    std::vector<double> const &xpoints,
+    HCDefsView const &xpoints,
     double xx)
 {
     int n = xpoints.size();
@@ -69,12 +69,20 @@ static int nearest_1d(
 
 // --------------------------------------------------------
 extern void linterp_1d_b(
-    std::vector<double> const &xpoints,
+    HCDefsView const &xpoints,
     double xx,
     long *indices, double *weights)  // Size-2 arrays
 {
     int n = xpoints.size();
 
+    // A cell with just one elevation class (eg low relief)
+    if (n == 1) {
+        indices[0] = indices[1] = 0;
+        weights[0] = 1.0;
+        weights[1] = 0.0;
+        return;
+    }
+
     // This is the point ABOVE our value.
     // (i0 = i1 - 1, xpoints[i0] < xx <= xpoints[i1])
     // See: http://www.cplusplus.com/reference/algorithm/lower_bound/
@@ -104,8 +112,9 @@ void IceRegridder_L0::GvEp(
 {
 printf("BEGIN IceRegridder_L0::GvEp()\n");
     blitz::Array<double,1> const &elevmaskI(*_elevmaskI);
+    auto const &aexgrid(this->aexgrid());
 
-    if (gcm->hcdefs().size() == 0) (*icebin_error)(-1,
+    if (gcm->hcdefs().size() == 0 && gcm->hcdefsA_offsets.size() == 0) (*icebin_error)(-1,
         "IceRegridder_L0::GvEp(): hcdefs is zero-length!");
 
     // ---------------------------------------
@@ -122,13 +131,18 @@ printf("BEGIN IceRegridder_L0::GvEp()\n");
             // This cell not masked: look up elevation point as usual
             double const elevation = std::max(elevmaskI(iI), 0.0);
 
+            // Elevation classes used by this GCM cell
+            HCDefsView const hcdefs(gcm->hcdefs(iA));
+            if (hcdefs.size() == 0) (*icebin_error)(-1,
+                "IceRegridder_L0::GvEp(): A cell %ld has ice but no elevation classes", iA);
+
             // Interpolate in height points
             switch(interp_style.index()) {
                 case InterpStyle::Z_INTERP :
                 {
                     long ihps[2];
                     double whps[2];
-                    linterp_1d_b(gcm->hcdefs(), elevation, ihps, whps);
+                    linterp_1d_b(hcdefs, elevation, ihps, whps);
 
                     if (whps[0] != 0) {
                         auto const iE0 = gcm->indexingHC.tuple_to_index<long,2>({iA, ihps[0]});
@@ -144,7 +158,7 @@ printf("BEGIN IceRegridder_L0::GvEp()\n");
 
                 } break;
                 case InterpStyle::ELEV_CLASS_INTERP : {
-                    int ihps0 = nearest_1d(gcm->hcdefs(), elevation);
+                    int ihps0 = nearest_1d(hcdefs, elevation);
                     ret.add({iG, gcm->indexingHC.tuple_to_index<long,2>({iA, ihps0})},
                         aexgrid.native_area(id));
                 } break;
@@ -160,6 +174,8 @@ void IceRegridder_L0::GvI(
     blitz::Array<double,1> const *_elevmaskI) const
 {
     blitz::Array<double,1> const &elevmaskI(*_elevmaskI);
+    auto const &agridI(this->agridI());
+    auto const &aexgrid(this->aexgrid());
     if (gridG == 'I') {
         // Ice <- Ice = Indentity Matrix (scaled)
         // But we need this unscaled... so we use the weight of
@@ -196,6 +212,7 @@ void IceRegridder_L0::GvAp(
 {
 printf("BEGIN IceRegridder_L0::GvAp()\n");
     blitz::Array<double,1> const &elevmaskI(*_elevmaskI);
+    auto const &aexgrid(this->aexgrid());
     for (int id=0; id<aexgrid.dense_extent(); ++id) {
         long const iG = (gridG == 'I' ?
             aexgrid.ijk(id,1) : aexgrid.to_sparse(id));
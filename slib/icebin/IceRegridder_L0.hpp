@@ -27,11 +27,11 @@ class IceRegridder_L0 : public IceRegridder
 public:
     /** Number of grid cells in the ice grid */
     size_t nI() const
-        { return agridI.dim.sparse_extent(); }
+        { return agridI().dim.sparse_extent(); }
 
     /** Number of grid cells in the interpolation grid */
     size_t nX() const
-        { return aexgrid.sparse_extent(); }
+        { return aexgrid().sparse_extent(); }
 
     /** Number of grid cells in the Ice (I) or Exchange (X) grids.
     @param gridG Either 'I' or 'X' */
@@ -238,7 +238,7 @@ std::unique_ptr<linear::Weighted_Eigen> compute_IvAE(
 
         // Obtain the smoothing matrix (smoother.hpp)
         TupleListT<2> smoothI_t({dimI->dense_extent(), dimI->dense_extent()});
-        smoothing_matrix(smoothI_t, regridder->agridI,
+        smoothing_matrix(smoothI_t, regridder->agridI(),
             *dimI, *elevmaskI, ret->wM, params.sigma);
         EigenSparseMatrixT smoothI(smoothI_t.shape(0), smoothI_t.shape(1));
         smoothI.setFromTriplets(smoothI_t.begin(), smoothI_t.end());
@@ -0,0 +1,65 @@
+#include <cmath>
+#include <cerrno>
+#include <cstring>
+#include <icebin/error.hpp>
+#include <icebin/audit.hpp>
+
+namespace icebin {
+
+ConservationAuditor::ConservationAuditor(std::string const &_fname, double _rtol)
+    : fname(_fname), rtol(_rtol)
+{
+    fout = fopen(fname.c_str(), "a");
+    if (!fout) (*icebin_error)(-1,
+        "Cannot open budget file %s: %s", fname.c_str(), strerror(errno));
+}
+
+ConservationAuditor::~ConservationAuditor()
+{
+    fclose(fout);
+}
+
+/** @return Weighted integral of column ivar of vv.  Cells with zero
+weight are skipped, so NaNs outside the domain do not propagate. */
+static double integral(
+    blitz::Array<double,1> const &ww,
+    Eigen::Ref<EigenDenseMatrixT const> const &vv,
+    int ivar)
+{
+    double sum = 0;
+    if (ww.size() == 0) {
+        for (int i=0; i<vv.rows(); ++i) sum += vv(i,ivar);
+    } else {
+        for (int i=0; i<vv.rows(); ++i) {
+            double const w = ww(i);
+            if (w != 0) sum += w * vv(i,ivar);
+        }
+    }
+    return sum;
+}
+
+void ConservationAuditor::audit(double time_s,
+    std::string const &regrid,
+    VarSet const &vars,
+    blitz::Array<double,1> const &wB,
+    Eigen::Ref<EigenDenseMatrixT const> const &vB,
+    blitz::Array<double,1> const &wA,
+    Eigen::Ref<EigenDenseMatrixT const> const &vA)
+{
+    for (int ivar=0; ivar<vars.size(); ++ivar) {
+        double const before = integral(wB, vB, ivar);
+        double const after = integral(wA, vA, ivar);
+        double const denom = std::max(std::abs(before), std::abs(after));
+        double const reldiff = (denom == 0 ? 0 : (after - before) / denom);
+
+        fprintf(fout, "%.17g %s %s %.17g %.17g %.3e\n",
+            time_s, regrid.c_str(), vars[ivar].name.c_str(),
+            before, after, reldiff);
+        if (!(std::abs(reldiff) <= rtol)) printf(
+            "ConservationAuditor: %s %s not conserved at t=%g: %g -> %g (reldiff %g)\n",
+            regrid.c_str(), vars[ivar].name.c_str(), time_s, before, after, reldiff);
+    }
+    fflush(fout);
+}
+
+}    // namespace
@@ -0,0 +1,55 @@
+#ifndef ICEBIN_AUDIT_HPP
+#define ICEBIN_AUDIT_HPP
+
+#include <cstdio>
+#include <string>
+#include <blitz/array.h>
+#include <icebin/eigen_types.hpp>
+#include <icebin/VarSet.hpp>
+
+/** Conservation auditing for the coupling path.  Each time a regrid
+matrix is applied, the weighted integral (w.v) of every variable is
+computed on the source and destination grids.  A conservative regrid
+leaves these equal to within round-off.  The weights must not be
+derived from the matrix being audited (eg: its own row / column
+sums), or the two sides agree by construction.  The budgets are appended to
+a small text file, one line per (time, regrid, variable):
+
+    time_s  regrid  variable  before  after  reldiff
+
+This is cheap (one pass over the regridded arrays) and can be left on
+in production runs. */
+
+namespace icebin {
+
+class ConservationAuditor {
+    std::string const fname;
+    FILE *fout;
+
+public:
+    /** Relative differences larger than this are also printed to STDOUT */
+    double const rtol;
+
+    /** @param _fname File to which budgets are appended. */
+    ConservationAuditor(std::string const &_fname, double _rtol = 1e-8);
+    ~ConservationAuditor();
+
+    /** Records the budget of one regrid application.
+    Values are (cell, variable); so each column is one variable.
+    @param regrid Name of the regrid (eg: "IvE")
+    @param vars Names of the variables (columns)
+    @param wB Weights of the source grid cells; empty for all 1
+    @param vB Values on the source grid
+    @param wA Weights of the destination grid cells; empty for all 1
+    @param vA Values on the destination grid */
+    void audit(double time_s,
+        std::string const &regrid,
+        VarSet const &vars,
+        blitz::Array<double,1> const &wB,
+        Eigen::Ref<EigenDenseMatrixT const> const &vB,
+        blitz::Array<double,1> const &wA,
+        Eigen::Ref<EigenDenseMatrixT const> const &vA);
+};
+
+}    // namespace
+#endif    // guard
@@ -27,4 +27,14 @@ namespace icebin {
 
 everytrace_error_ptr icebin_error = &everytrace_error_default;
 
+void throw_error(int retcode, char const *format, ...)
+{
+    char buf[1024];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(buf, sizeof(buf), format, args);
+    va_end(args);
+    throw Error(retcode, buf);
+}
+
 }   // Namespace
@@ -19,6 +19,8 @@
 #ifndef ICEBIN_ERROR_HPP
 #define ICEBIN_ERROR_HPP
 
+#include <string>
+#include <stdexcept>
 #include <everytrace.hpp>
 
 /** @defgroup icebin icebin.hpp
@@ -31,6 +33,19 @@ typedef everytrace::Exception Exception;
     library can change if needed. */
 extern everytrace_error_ptr icebin_error;
 
+/** Thrown by throw_error() */
+class Error : public std::runtime_error {
+public:
+    int const retcode;
+    Error(int _retcode, std::string const &msg)
+        : std::runtime_error(msg), retcode(_retcode) {}
+};
+
+/** Alternate error handler that throws icebin::Error, rather than
+exiting.  For long-running services and tests, which must survive a
+bad input:  icebin_error = &throw_error; */
+extern void throw_error(int retcode, char const *format, ...);
+
 }   // namespace
 /** @} */
 
@@ -0,0 +1,100 @@
+#ifndef ICEBIN_FROZEN_SPARSE_SET_HPP
+#define ICEBIN_FROZEN_SPARSE_SET_HPP
+
+#include <algorithm>
+#include <vector>
+#include <memory>
+#include <icebin/eigen_types.hpp>
+#include <icebin/error.hpp>
+
+namespace icebin {
+
+/** Read-only copy of a spsparse::SparseSet, for per-element loops on
+the coupling path.  SparseSet::to_dense() is a hash lookup; here it
+is a flat array indexed by sparse index, or (when the sparse extent
+is large compared to the dense extent) a two-level page table that
+only allocates pages containing at least one element.
+
+Build it once the SparseSet will no longer change; it does not
+follow later changes to the original. */
+template<class SparseT, class DenseT>
+class FrozenSparseSet {
+    static int const PAGE_BITS = 12;
+    static SparseT const PAGE_SIZE = (SparseT)1 << PAGE_BITS;
+    static SparseT const PAGE_MASK = PAGE_SIZE - 1;
+
+    SparseT _sparse_extent;
+    std::vector<SparseT> _d2s;
+
+    // Flat lookup: _s2d[sparse] = dense, or -1
+    std::vector<DenseT> _s2d;
+
+    // Paged lookup: _pages[sparse >> PAGE_BITS][sparse & PAGE_MASK]
+    std::vector<std::unique_ptr<DenseT[]>> _pages;
+
+public:
+    /** Sparse extents up to this many times the dense extent get a
+    flat table; beyond that, a page table. */
+    static SparseT const MAX_FLAT_RATIO = 16;
+
+    /** @param dim The SparseSet to copy.  If its sparse extent was
+        never set, it is taken to end after the largest sparse index. */
+    template<class SetT>
+    explicit FrozenSparseSet(SetT const &dim)
+        : _sparse_extent(std::max<SparseT>(0, dim.sparse_extent()))
+    {
+        DenseT const nd = dim.dense_extent();
+        _d2s.reserve(nd);
+        for (DenseT id=0; id<nd; ++id) {
+            SparseT const is = dim.to_sparse(id);
+            _d2s.push_back(is);
+            if (is >= _sparse_extent) _sparse_extent = is+1;
+        }
+
+        if (_sparse_extent <= PAGE_SIZE || _sparse_extent <= MAX_FLAT_RATIO * nd) {
+            _s2d.resize(_sparse_extent, -1);
+            for (DenseT id=0; id<nd; ++id) _s2d[_d2s[id]] = id;
+        } else {
+            _pages.resize((_sparse_extent + PAGE_SIZE - 1) >> PAGE_BITS);
+            for (DenseT id=0; id<nd; ++id) {
+                SparseT const is = _d2s[id];
+                auto &page(_pages[is >> PAGE_BITS]);
+                if (!page) {
+                    page.reset(new DenseT[PAGE_SIZE]);
+                    std::fill(page.get(), page.get() + PAGE_SIZE, (DenseT)-1);
+                }
+                page[is & PAGE_MASK] = id;
+            }
+        }
+    }
+
+    SparseT sparse_extent() const { return _sparse_extent; }
+    DenseT dense_extent() const { return _d2s.size(); }
+
+    /** @return Dense index of sparse_ix, or -1 if it is not in the set. */
+    DenseT find_dense(SparseT sparse_ix) const
+    {
+        if (sparse_ix < 0 || sparse_ix >= _sparse_extent) return -1;
+        if (_pages.size() == 0) return _s2d[sparse_ix];
+        auto const &page(_pages[sparse_ix >> PAGE_BITS]);
+        return page ? page[sparse_ix & PAGE_MASK] : -1;
+    }
+
+    /** Like SparseSet::to_dense(), raises an error if sparse_ix is not
+    in the set. */
+    DenseT to_dense(SparseT sparse_ix) const
+    {
+        DenseT const id = find_dense(sparse_ix);
+        if (id < 0) (*icebin_error)(-1,
+            "Sparse index %ld not in FrozenSparseSet", (long)sparse_ix);
+        return id;
+    }
+
+    SparseT to_sparse(DenseT dense_ix) const
+        { return _d2s[dense_ix]; }
+};
+
+typedef FrozenSparseSet<sparse_index_type, dense_index_type> FrozenSparseSetT;
+
+}    // namespace icebin
+#endif    // guard
@@ -37,6 +37,7 @@
 #include <spsparse/accum.hpp>
 #include <spsparse/eigen.hpp>
 #include <spsparse/SparseSet.hpp>
+#include <icebin/shared_store.hpp>
 
 // See here to serialize objects with non-default constructor
 //    http://www.boost.org/doc/libs/1_62_0/libs/serialization/doc/serialization.html#constructors
@@ -75,20 +76,101 @@ using namespace icebin::contracts;
 
 // ======================================================================
 
-/** @param endj Last(+1) element of each domain (0-based indexing) */
 DomainDecomposer_ModelE::DomainDecomposer_ModelE(
-    std::vector<int> const &endj,
-    ibmisc::Domain const &_domainA_global) :    // Starts from ModelE; j indexing base=1
-domainA_global(_domainA_global),
-rank_of_j(endj[endj.size()-1], blitz::fortranArray)    // Allocate for 1-based indexing
+    std::vector<int> &&_rank_of_iA, size_t _ndomain) :
+ndomain(_ndomain),
+rank_of_iA(std::move(_rank_of_iA))
 {
-    ndomain = endj.size();    // startj contains an extra sentinel item at the end
-    int j=0;
-    for (int irank=0; irank<ndomain; ++irank) {
-        for (; j < endj[irank]; ++j)
-            rank_of_j(j) = irank;    // zero-based indexing for j
+    for (size_t iA=0; iA<rank_of_iA.size(); ++iA) {
+        int const rank = rank_of_iA[iA];
+        if (rank < 0 || rank >= ndomain) (*icebin_error)(-1,
+            "Grid cell iA=%ld has MPI rank %d, out of range [0, %ld)",
+            (long)iA, rank, (long)ndomain);
+    }
+}
+
+bool blocks_partition(
+    std::vector<ibmisc::Domain> const &domains,
+    ibmisc::Domain const &domainA_global)
+{
+    long const im = domainA_global[0].end;
+    long const jm = domainA_global[1].end;
+    std::vector<int> count(im*jm, 0);
+
+    for (auto const &domain : domains) {
+        for (long j=domain[1].begin; j < domain[1].end; ++j) {
+        for (long i=domain[0].begin; i < domain[0].end; ++i) {
+            if (++count[j*im + i] > 1) return false;
+        }}
+    }
+    for (int n : count) if (n != 1) return false;
+    return true;
+}
+
+std::vector<int> rank_of_iA_from_blocks(
+    std::vector<ibmisc::Domain> const &domains,
+    ibmisc::Domain const &domainA_global)
+{
+    long const im = domainA_global[0].end;
+    long const jm = domainA_global[1].end;
+    std::vector<int> rank_of_iA(im*jm, -1);
+
+    for (int irank=0; irank<domains.size(); ++irank) {
+        auto const &domain(domains[irank]);
+        for (long j=domain[1].begin; j < domain[1].end; ++j) {
+        for (long i=domain[0].begin; i < domain[0].end; ++i) {
+            long const iA = j*im + i;
+            if (rank_of_iA[iA] >= 0) (*icebin_error)(-1,
+                "Grid cell (i,j)=(%ld,%ld) is in the domains of MPI ranks %d and %d",
+                i, j, rank_of_iA[iA], irank);
+            rank_of_iA[iA] = irank;
+        }}
+    }
+
+    for (long iA=0; iA<im*jm; ++iA) {
+        if (rank_of_iA[iA] < 0) (*icebin_error)(-1,
+            "Grid cell (i,j)=(%ld,%ld) is not in any MPI rank's domain",
+            iA % im, iA / im);
+    }
+    return rank_of_iA;
+}
+
+void check_rank_of_iA(
+    std::vector<int> const &rank_of_iA,
+    std::vector<ibmisc::Domain> const &domains,
+    ibmisc::Domain const &domainA_global)
+{
+    long const im = domainA_global[0].end;
+    long const jm = domainA_global[1].end;
+    if (rank_of_iA.size() != im*jm) (*icebin_error)(-1,
+        "Owner map has %ld cells, expected %ld", (long)rank_of_iA.size(), im*jm);
+
+    for (long iA=0; iA<im*jm; ++iA) {
+        long const i = iA % im;
+        long const j = iA / im;
+        int const rank = rank_of_iA[iA];
+        if (rank < 0 || rank >= domains.size()) (*icebin_error)(-1,
+            "Grid cell (i,j)=(%ld,%ld) has MPI rank %d, out of range [0, %ld)",
+            i, j, rank, (long)domains.size());
+
+        auto const &domain(domains[rank]);
+        if (i < domain[0].begin || i >= domain[0].end
+            || j < domain[1].begin || j >= domain[1].end) (*icebin_error)(-1,
+            "Grid cell (i,j)=(%ld,%ld) is assigned to MPI rank %d, "
+            "outside its block [%ld,%ld)x[%ld,%ld)",
+            i, j, rank, domain[0].begin, domain[0].end,
+            domain[1].begin, domain[1].end);
+    }
+}
 
+std::vector<long> owned_cells(
+    std::vector<int> const &rank_of_iA, int rank)
+{
+    std::vector<long> ret;
+    for (size_t iA=0; iA<rank_of_iA.size(); ++iA) {
+        if (rank_of_iA[iA] == rank) ret.push_back(iA);
     }
+    return ret;
 }
 
 // ======================================================================
@@ -237,6 +319,26 @@ end_rsf:
     return params;
 }
 // -----------------------------------------------------
+/** ModelE regridders (with their EOpvAOp_base) shared among ensemble
+members, keyed on the global_ec file and the underlying (shared)
+ocean-grid regridder. */
+static SharedStore<
+    std::pair<std::string, GCMRegridder_Standard const *>,
+    modele::GCMRegridder_ModelE> shared_modele_regridders;
+
+std::shared_ptr<GCMRegridder_ModelE> get_modele_regridder(
+    std::string const &global_ecO_fname,
+    std::shared_ptr<GCMRegridder_Standard> const &gcmO,
+    bool share)
+{
+    auto const load_gcmA = [&global_ecO_fname, &gcmO]() {
+        return std::make_shared<GCMRegridder_ModelE>(global_ecO_fname, gcmO);
+    };
+    if (!share) return load_gcmA();
+    return shared_modele_regridders.get(
+        std::make_pair(global_ecO_fname, gcmO.get()), load_gcmA);
+}
+
 void GCMCoupler_ModelE::_ncread(
     ibmisc::NcIO &ncio_config,
     std::string const &vname)        // comes from this->gcm_params
@@ -253,14 +355,16 @@ void GCMCoupler_ModelE::_ncread(
 
     // Let's assume that the EOvAO matrix is included in topoO_fname
 
+    std::shared_ptr<modele::GCMRegridder_ModelE> gcmA(get_modele_regridder(
+        global_ecO_fname,
+        std::dynamic_pointer_cast<GCMRegridder_Standard>(gcm_regridder),
+        gcm_params.share_regridders));
+
     // Replace the GCMRegridder with a wrapped version that understands
-    // the ocean-vs-atmosphere grid complexity of ModelE
+    // the ocean-vs-atmosphere grid complexity of ModelE.
+    // (Each member has its own wrapper: foceanOp and foceanOm are per-member)
     gcm_regridder.reset(
-        new modele::GCMRegridder_WrapE(    // allocates foceanOp and foceanOm
-            std::unique_ptr<modele::GCMRegridder_ModelE>(
-                new modele::GCMRegridder_ModelE(
-                    global_ecO_fname,
-                    std::dynamic_pointer_cast<GCMRegridder_Standard>(gcm_regridder)))));
+        new modele::GCMRegridder_WrapE(gcmA));    // allocates foceanOp and foceanOm
 }
 // -----------------------------------------------------
 // Called from LISnow::allocate()
@@ -275,33 +379,29 @@ std::string GCMCoupler_ModelE::locate_input_file(
 }
 // -----------------------------------------------------
 // ===========================================================
-/** Reads from file ./config/icebin.nc */
-extern "C"
-GCMCoupler_ModelE *gcmce_new(
+/** Body of gcmce_new() and gcmce_new_member()
+@param config_fname IceBin config file to read
+@param share_regridders See GCMParams::share_regridders */
+static GCMCoupler_ModelE *new_gcmce(
     ModelEParams const &_rdparams,
-
-    // Info about the global grid
     int im, int jm,
-
-    // Info about the local grid (1-based indexing, closed ranges)
     int i0_f, int i1_f, int j0_f, int j1_f,
-
-    // MPI Stuff
-    MPI_Fint comm_f, int root)
+    MPI_Fint comm_f, int root,
+    std::string const &config_fname,
+    bool share_regridders)
 {
-printf("BEGIN gcmce_new()\n");
-
     std::unique_ptr<GCMCoupler_ModelE> self(
         new GCMCoupler_ModelE(GCMParams(MPI_Comm_f2c(comm_f), root)));
 
     self->rdparams = &_rdparams;
     GCMParams &gcm_params(self->gcm_params);
+    gcm_params.share_regridders = share_regridders;
 
     // Domains and indexing are alphabetical indexes, zero-based, open ranges
     self->domainA = ibmisc::Domain({i0_f-1,j0_f-1}, {i1_f, j1_f});
     self->domainA_global = ibmisc::Domain({0,0}, {im, jm});
 
-    gcm_params.icebin_config_fname = boost::filesystem::absolute("config/icebin.nc").string();
+    gcm_params.icebin_config_fname = boost::filesystem::absolute(config_fname).string();
 
     // Read the coupler, along with ice model proxies
     self->ncread(gcm_params.icebin_config_fname, "m");
@@ -315,20 +415,147 @@ printf("BEGIN gcmce_new()\n");
 
     /** Creates (on root) a picture of the full domain decomposition.
     Run from all MPI ranks... */
-    std::vector<int> endj;
-    int endme = self->domainA[1].end;
+    std::vector<int> blocks;    // (i0,j0,i1,j1) for each rank
+    int blockme[4];
+    blockme[0] = self->domainA[0].begin;
+    blockme[1] = self->domainA[1].begin;
+    blockme[2] = self->domainA[0].end;
+    blockme[3] = self->domainA[1].end;
     boost::mpi::gather<int>(self->gcm_params.world,
-        &endme, 1,    // In-values
-        endj, self->gcm_params.gcm_root);                    // Out-values, root
+        blockme, 4,    // In-values
+        blocks, self->gcm_params.gcm_root);                    // Out-values, root
+    // If the blocks partition the grid, each rank owns its block.
+    // Otherwise (eg: blocks with halos), the GCM must supply the owner
+    // map with gcmce_set_domain_decomposition() before coupling.
+    std::vector<int> rank_of_iA;
     if (self->am_i_root()) {
-        self->domains.reset(
-            new DomainDecomposer_ModelE(endj, self->domainA_global));
+        std::vector<ibmisc::Domain> domains;
+        for (size_t i=0; i<blocks.size(); i += 4) {
+            domains.push_back(ibmisc::Domain(
+                {blocks[i+0], blocks[i+1]}, {blocks[i+2], blocks[i+3]}));
+        }
+        if (blocks_partition(domains, self->domainA_global))
+            rank_of_iA = rank_of_iA_from_blocks(domains, self->domainA_global);
+        self->domain_blocks = std::move(domains);
     }
+    bool partition = (rank_of_iA.size() > 0);
+    boost::mpi::broadcast(self->gcm_params.world, partition, self->gcm_params.gcm_root);
+    if (partition) self->set_rank_of_iA(std::move(rank_of_iA));
 
     // TODO: Test that im and jm are consistent with the grid read.
     GCMCoupler_ModelE *ret = self.release();
     return ret;
 }
+
+/** Reads from file ./config/icebin.nc */
+extern "C"
+GCMCoupler_ModelE *gcmce_new(
+    ModelEParams const &_rdparams,
+
+    // Info about the global grid
+    int im, int jm,
+
+    // Info about the local grid (1-based indexing, closed ranges)
+    int i0_f, int i1_f, int j0_f, int j1_f,
+
+    // MPI Stuff
+    MPI_Fint comm_f, int root)
+{
+printf("BEGIN gcmce_new()\n");
+    return new_gcmce(_rdparams, im, jm, i0_f, i1_f, j0_f, j1_f,
+        comm_f, root, "config/icebin.nc", false);
+}
+
+/** Creates one member of an ensemble run within a single process.
+Members that read the same grid and global_ec files share one copy of
+the (immutable) regridders and base matrices; each member keeps its
+own elevmasks, XuE0s, ice couplers, etc.
+@param config_fname IceBin config file for this member (eg: config/icebin-m01.nc) */
+extern "C"
+GCMCoupler_ModelE *gcmce_new_member(
+    ModelEParams const &_rdparams,
+    int im, int jm,
+    int i0_f, int i1_f, int j0_f, int j1_f,
+    MPI_Fint comm_f, int root,
+    char const *config_fname_f, int config_fname_len)
+{
+    std::string const config_fname(config_fname_f, config_fname_len);
+printf("BEGIN gcmce_new_member(%s)\n", config_fname.c_str());
+    return new_gcmce(_rdparams, im, jm, i0_f, i1_f, j0_f, j1_f,
+        comm_f, root, config_fname, true);
+}
+// ==========================================================
+/** Sets the owner of each grid cell, replacing the one derived in
+gcmce_new() (if any).  Required if the blocks passed to gcmce_new()
+overlap or leave gaps (eg: 2-D decompositions with halos).  Any map
+is accepted, as long as each cell lies within the block (from
+gcmce_new()) of the rank that owns it; see check_rank_of_iA().
+Called from all MPI ranks; only root's array is used.
+@param rank_of_ij_f(im,jm) MPI rank owning each grid cell (Fortran order) */
+extern "C"
+void gcmce_set_domain_decomposition(GCMCoupler_ModelE *self, int const *rank_of_ij_f)
+{
+    // Fortran (im,jm) order is the same as iA = j*im + i
+    std::vector<int> rank_of_iA;
+    if (self->am_i_root()) {
+        long const nA = self->domainA_global[0].end * self->domainA_global[1].end;
+        rank_of_iA.assign(rank_of_ij_f, rank_of_ij_f + nA);
+    }
+    self->set_rank_of_iA(std::move(rank_of_iA));
+}
+
+void GCMCoupler_ModelE::set_rank_of_iA(std::vector<int> &&rank_of_iA)
+{
+    if (am_i_root()) {
+        check_rank_of_iA(rank_of_iA, domain_blocks, domainA_global);
+    }
+
+    // Every rank needs its own list of owned cells
+    boost::mpi::broadcast(gcm_params.world, rank_of_iA, gcm_params.gcm_root);
+    owned_iA = owned_cells(rank_of_iA, gcm_params.world.rank());
+    have_owner_map = true;
+
+    if (am_i_root()) {
+        domains.reset(new DomainDecomposer_ModelE(
+            std::move(rank_of_iA), gcm_params.world.size()));
+    }
+}
+// ==========================================================
+/** Allows regrid matrices and TOPO to be reused between couplings when
+the ice sheet has changed little since they were built.
+@param max_delev Largest change in elevation [m] of any ice or land grid cell;
+    negative to always rebuild (the default).
+@param max_ncross Number of ice grid cells allowed to enter/leave the
+    ice or land mask or change elevation class. */
+extern "C"
+void gcmce_set_rebuild_tolerance(GCMCoupler_ModelE *self, double max_delev, int max_ncross)
+{
+    self->gcm_params.rebuild_max_delev = max_delev;
+    self->gcm_params.rebuild_max_ncross = max_ncross;
+}
+// ==========================================================
+/** Turns on conservation auditing: each ice sheet appends per-regrid,
+per-variable budgets to budget.txt in its output directory. */
+extern "C"
+void gcmce_set_audit(GCMCoupler_ModelE *self, bool audit)
+{
+    self->gcm_params.audit_conservation = audit;
+}
+
+/** Single precision is adequate for most coupling fields, and halves
+the volume of the root-to-rank scatter. */
+extern "C"
+void gcmce_set_scatter_float(GCMCoupler_ModelE *self, bool scatter_float)
+{
+    self->gcm_params.scatter_float = scatter_float;
+}
+
+/** Saves root memory on multi-sheet, high-resolution runs. */
+extern "C"
+void gcmce_set_compress_held_matrices(GCMCoupler_ModelE *self, bool compress)
+{
+    self->gcm_params.compress_held_matrices = compress;
+}
 // ==========================================================
 // Called from LISheetIceBin::_read_nhc_gcm()
 
@@ -661,9 +888,125 @@ std::vector<GCMInput> split_by_domain(
     return outs;
 }
 
+static bool same_tuples(
+    spsparse::TupleList<int,double,2> const &a,
+    spsparse::TupleList<int,double,2> const &b)
+{
+    if (a.shape() != b.shape() || a.tuples.size() != b.tuples.size()) return false;
+    for (size_t i=0; i<a.tuples.size(); ++i) {
+        auto const &ta(a.tuples[i]);
+        auto const &tb(b.tuples[i]);
+        if (ta.index() != tb.index() || ta.value() != tb.value()) return false;
+    }
+    return true;
+}
+
+/** Prepares per-domain outputs for the wire: marks E1vE0c payloads
+identical to the ones last sent (so they are omitted), and selects the
+precision of the values. */
+void compact_for_scatter(GCMCoupler_ModelE *self,
+    std::vector<GCMInput> &every_outs, bool run_ice)
+{
+    if (!run_ice) {
+        // Ranks do not keep E1vE0c across initialization calls
+        self->E1vE0c_sent.clear();
+    } else if (self->E1vE0c_sent.size() != every_outs.size()) {
+        self->E1vE0c_sent.clear();
+        for (auto &eout : every_outs) self->E1vE0c_sent.push_back(eout.E1vE0c);
+    } else {
+        for (size_t i=0; i<every_outs.size(); ++i) {
+            auto &eout(every_outs[i]);
+            if (same_tuples(eout.E1vE0c, self->E1vE0c_sent[i])) {
+                eout.E1vE0c_unchanged = true;
+            } else {
+                self->E1vE0c_sent[i] = eout.E1vE0c;
+            }
+        }
+    }
+
+    for (auto &eout : every_outs) {
+        for (auto &vm : eout.gcm_ivalss_s) vm.wire_float = self->gcm_params.scatter_float;
+    }
+}
 
 // =======================================================
 // Called from LISheetIceBin::couple()
+/** Splits a 0-based index of a rank-2 Indexing into its (0-based)
+tuple, in the same way as Indexing::index_to_tuple(); but with the
+strides worked out once, so it can be used in a tight loop. */
+struct Index2Splitter {
+    int major, minor;    // Dimension with largest / smallest stride
+    long stride;         // Stride of the major dimension
+    std::array<long,2> base;
+
+    Index2Splitter(ibmisc::Indexing const &indexing)
+    {
+        if (indexing.rank() != 2) (*icebin_error)(-1,
+            "Index2Splitter needs rank=2 (vs. %d)", (int)indexing.rank());
+        major = indexing.indices()[0];
+        minor = indexing.indices()[1];
+        stride = indexing[minor].extent;
+        base = {indexing[0].base, indexing[1].base};
+    }
+};
+
+/** Builds the E1vE0c matrix handed to Fortran directly in its final
+(column-wise) layout.  Index columns are i, j, ihc1, ihc0 (1-based).
+@param E1vE0c_s E1vE0c, as received from root (elevation-class indexing)
+@param indexingHC Splits E indices into (iA, ihc)
+@param indexingA Splits A indices into (i, j) */
+static void export_E1vE0c(
+    VectorSparseSoA<int,double,4> &ret,
+    spsparse::TupleList<int,double,2> const &E1vE0c_s,
+    ibmisc::Indexing const &indexingHC,
+    ibmisc::Indexing const &indexingA)
+{
+    Index2Splitter const sHC(indexingHC);
+    Index2Splitter const sA(indexingA);
+
+    // Sized up front; storage is reused from the previous call
+    long const n = E1vE0c_s.tuples.size();
+    ret.resize(n);
+    int * const ci(ret.col(0));
+    int * const cj(ret.col(1));
+    int * const chc1(ret.col(2));
+    int * const chc0(ret.col(3));
+    double * const vals(ret.values.data());
+
+    // Pass 1: Split E indices into (iA, ihc); iA goes temporarily in ci
+    long nbad = 0;
+    for (long k=0; k<n; ++k) {
+        auto const &tp(E1vE0c_s.tuples[k]);
+        long const iE1 = tp.index(0);
+        long const iE0 = tp.index(1);
+        long const q1 = iE1 / sHC.stride;
+        long const q0 = iE0 / sHC.stride;
+        long const r1 = iE1 - q1 * sHC.stride;
+        long const r0 = iE0 - q0 * sHC.stride;
+
+        long const iA1 = (sHC.major == 0 ? q1 : r1);
+        long const iA0 = (sHC.major == 0 ? q0 : r0);
+        nbad += (iA1 != iA0);
+
+        // +1: Convert to Fortran 1-based Indexing
+        ci[k] = iA0 + sHC.base[0];
+        chc1[k] = (sHC.major == 0 ? r1 : q1) + sHC.base[1] + 1;
+        chc0[k] = (sHC.major == 0 ? r0 : q0) + sHC.base[1] + 1;
+        vals[k] = tp.value();
+    }
+    if (nbad != 0) (*icebin_error)(-1,
+        "%ld elements of E1vE0c cross between A gridcells", nbad);
+
+    // Pass 2: Split iA into (i,j); pure integer arithmetic on contiguous columns
+    for (long k=0; k<n; ++k) {
+        long const iA = ci[k];
+        long const q = iA / sA.stride;
+        long const r = iA - q * sA.stride;
+        ci[k] = (sA.major == 0 ? q : r) + sA.base[0] + 1;
+        cj[k] = (sA.major == 0 ? r : q) + sA.base[1] + 1;
+    }
+}
+
 /**
 This will:
 1. Simultaneously:
@@ -692,18 +1035,25 @@ Put elsewhere in the Fortran code:
 @param hc_offset Offset of first IceBin elevation class in GCM's set
     of EC's (zero-based).
 */
-extern "C"
-void gcmce_couple_native(GCMCoupler_ModelE *self,
+static void couple_native(GCMCoupler_ModelE *self,
 int itime,
 bool run_ice,    // if false, only initialize
-// https://stackoverflow.com/questions/30152073/how-to-pass-c-pointer-to-fortran
-// Return the E1vE0 matrix here
+std::vector<blitz::Array<double,3> const *> const &gcm_ovalsE,
 int **E1vE0c_indices_p,
 double **E1vE0c_values_p,
 int *E1vE0c_nele)
 {
     double time_s = itime * self->dtsrc;
 
+    // Report each phase's time to self->on_phase, if set
+    double tphase = MPI_Wtime();
+    auto const phase_done = [self, &tphase](CouplePhase phase) {
+        if (!self->on_phase) return;
+        double const t = MPI_Wtime();
+        self->on_phase(phase, t - tphase);
+        tphase = t;
+    };
+
     // Fill it in...
     VectorMultivec gcm_ovalsE_s(self->gcm_outputsE.size());
     std::vector<double> val(self->gcm_outputsE.size());    // Temporary
@@ -721,18 +1071,23 @@ int *E1vE0c_nele)
     
 
     // Get values to send to IceBin
-    auto &domainA(self->domainA);
-printf("domainA size=%ld base_hc=%d  nhc_ice=%d\n", domainA.data.size(), base_hc, nhc_ice);
+    if (!self->have_owner_map) (*icebin_error)(-1,
+        "The blocks passed to gcmce_new() do not partition the grid; "
+        "call gcmce_set_domain_decomposition() before coupling");
+    long const im = self->domainA_global[0].end;
+printf("owned_iA size=%ld base_hc=%d  nhc_ice=%d\n", (long)self->owned_iA.size(), base_hc, nhc_ice);
 
     for (int ihc=base_hc; ihc < base_hc + nhc_ice; ++ihc) {
         const int ihc_ice = ihc - base_hc;   // Use only IceBin HC's, zero-based indexing
         if (ihc_ice < 0) (*icebin_error)(-1,
             "ihc_ice cannot be <0: %d = %d - %d - 1\n", ihc_ice, ihc, base_hc);
 
-        // Iterate over just this MPI rank's chunk
-        for (int j=domainA[1].begin; j < domainA[1].end; ++j) {
-        for (int i=domainA[0].begin; i < domainA[0].end; ++i) {
+        // Iterate over just the cells this MPI rank owns.  Its arrays
+        // may hold more (eg: halos), which other ranks send.
+        for (long iA : self->owned_iA) {
             // i,j are 0-based indexes.
+            int const i = iA % im;
+            int const j = iA / im;
             if (underice(ihc,j,i) == UI_LOCALICE || underice(ihc,j,i) == UI_GLOBALICE) {
 
                 long iE_s = indexingE.tuple_to_index(
@@ -742,14 +1097,15 @@ printf("domainA size=%ld base_hc=%d  nhc_ice=%d\n", domainA.data.size(), base_hc
                     "iE_s=%ld (from %d %d %d), it should not be negative\n", iE_s, i, j, ihc_ice);
 
                 for (unsigned int ivar=0; ivar<self->gcm_outputsE.size(); ++ivar) {
-                    val[ivar] = (*self->gcm_ovalsE[ivar])(ihc,j,i);
+                    val[ivar] = (*gcm_ovalsE[ivar])(ihc,j,i);
                 }
 
                 gcm_ovalsE_s.add({iE_s}, &val[0], 1.0);
             }    // if UI_LOCALICE or UI_GLOBALICE
-        }}
+        }
     }
-
+    if (self->on_gather) self->on_gather(gcm_ovalsE_s);
+    phase_done(CouplePhase::PACK);
 
     // Gather it to root
     // boost::mpi::communicator &gcm_world(world);
@@ -766,75 +1122,142 @@ printf("domainA size=%ld base_hc=%d  nhc_ice=%d\n", domainA.data.size(), base_hc
 
         // Concatenate coupler inputs
         VectorMultivec gcm_ovalsE_s(concatenate(every_gcm_ovalsE_s));
+        phase_done(CouplePhase::GATHER);
 
         // Couple on root!
         // out contains GLOBAL output for all MPI ranks
         out = self->couple(time_s, gcm_ovalsE_s, run_ice);  // move semantics
+        phase_done(CouplePhase::COUPLE);
 
         // Split up the output (and 
         std::vector<GCMInput> every_outs(
             split_by_domain(out, *self->domains, *self->domains));
+        phase_done(CouplePhase::SPLIT);
+        compact_for_scatter(self, every_outs, run_ice);
+        phase_done(CouplePhase::COMPACT);
 
         // Scatter!
         boost::mpi::scatter(self->gcm_params.world, every_outs, out, self->gcm_params.gcm_root);
+        phase_done(CouplePhase::SCATTER);
 
 
     } else {
         // =================== NOT MPI ROOT =============================
         // Send our input to root
         boost::mpi::gather(self->gcm_params.world, gcm_ovalsE_s, self->gcm_params.gcm_root);
+        phase_done(CouplePhase::GATHER);
 
         // Let root do the work...
         // update_topo() is built into this
         self->couple(time_s, gcm_ovalsE_s, run_ice);
+        phase_done(CouplePhase::COUPLE);
 
         // Receive our output back from root
         boost::mpi::scatter(self->gcm_params.world, out, self->gcm_params.gcm_root);
+        phase_done(CouplePhase::SCATTER);
     }
 
     // 1. Copies values back into modele.gcm_ivals from scatterd MPI stuff
     self->apply_gcm_ivals(out);
 
-    auto const &indexingHC(self->gcm_regridder->indexingHC);
     // Copy E1vE0 matrix back to Fortran
-    self->E1vE0c.clear();
-    if (run_ice) {
-        for (auto ii(out.E1vE0c.begin()); ii != out.E1vE0c.end(); ++ii) {
-            long const iE1(ii->index(0));
-            long const iE0(ii->index(1));
-            
-            auto ijk0(indexingHC.index_to_tuple<int,2>(iE0));
-            auto ijk1(indexingHC.index_to_tuple<int,2>(iE1));
-            if (ijk0[0] != ijk1[0]) (*icebin_error)(-1,
-                "ijk0 (%d) and ijk1 (%d) must match (%g)",
-                ijk0[0], ijk1[0], ii->value());
-            auto ij(indexingA.index_to_tuple<int,2>(ijk0[0]));
-
-            int const ihc0 = ijk0[1];
-            int const ihc1 = ijk1[1];
-
-            // +1: Convert to Fortran 1-based Indexing
-            self->E1vE0c.indices.push_back(ij[0]+1);
-            self->E1vE0c.indices.push_back(ij[1]+1);
-            self->E1vE0c.indices.push_back(ihc1+1);
-            self->E1vE0c.indices.push_back(ihc0+1);
-            self->E1vE0c.values.push_back(ii->value());
-        }
+    // (If unchanged, the copy from last time is still in self->E1vE0c)
+    if (!out.E1vE0c_unchanged) {
+        export_E1vE0c(self->E1vE0c, out.E1vE0c,
+            self->gcm_regridder->indexingHC, indexingA);
+    }
 
+    if (run_ice) {
         // Send E1vE0 back to ModelE in Fortran
         // See https://stackoverflow.com/questions/30152073/how-to-pass-c-pointer-to-fortran
-        // self->E1vE0c.export_matrix(*E1vE0c_indices_p, *E1vE0c_values_p, *E1vE0c_nele);
-        *E1vE0c_nele = self->E1vE0c.values.size();
-        *E1vE0c_indices_p = &self->E1vE0c.indices[0];
-        *E1vE0c_values_p = &self->E1vE0c.values[0];
+        *E1vE0c_nele = self->E1vE0c.size();
+        *E1vE0c_indices_p = self->E1vE0c.indices.data();
+        *E1vE0c_values_p = self->E1vE0c.values.data();
+    }
+    phase_done(CouplePhase::APPLY);
+}
 
+extern "C"
+void gcmce_couple_native(GCMCoupler_ModelE *self,
+int itime,
+bool run_ice,    // if false, only initialize
+// https://stackoverflow.com/questions/30152073/how-to-pass-c-pointer-to-fortran
+// Return the E1vE0 matrix here
+int **E1vE0c_indices_p,
+double **E1vE0c_values_p,
+int *E1vE0c_nele)
+{
+    std::vector<blitz::Array<double,3> const *> gcm_ovalsE;
+    for (auto &var : self->gcm_ovalsE) gcm_ovalsE.push_back(&*var);
 
+    couple_native(self, itime, run_ice, gcm_ovalsE,
+        E1vE0c_indices_p, E1vE0c_values_p, E1vE0c_nele);
+}
+// =======================================================
+/** Sets the number of GCM timesteps averaged together for each
+coupling, when the GCM calls gcmce_accumulate_native() every
+timestep.  Must be called by all MPI ranks. */
+extern "C"
+void gcmce_set_couple_every(GCMCoupler_ModelE *self, int nstep)
+{
+    if (nstep < 1) (*icebin_error)(-1,
+        "couple_every must be at least 1: %d", nstep);
+    self->couple_every = nstep;
+    self->naccum = 0;
+}
+
+/** Called every GCM timestep, in place of gcmce_couple_native().
+Adds gcm_ovalsE into per-rank running sums; that is cheap and
+requires no communication.  Every couple_every calls, the sums are
+averaged and coupling is done on the averages, as in
+gcmce_couple_native().
+@return true if coupling took place this timestep (and the E1vE0c
+    outputs are valid). */
+extern "C"
+bool gcmce_accumulate_native(GCMCoupler_ModelE *self,
+int itime,
+int **E1vE0c_indices_p,
+double **E1vE0c_values_p,
+int *E1vE0c_nele)
+{
+    auto &sums(self->gcm_ovalsE_sum);
+
+    // Allocate sums with the same bounds and storage order as ModelE's arrays
+    if (sums.size() != self->gcm_ovalsE.size()) {
+        sums.clear();
+        for (auto &var : self->gcm_ovalsE) {
+            sums.push_back(blitz::Array<double,3>(var->copy()));
+        }
+        self->naccum = 0;
     }
+
+    // Accumulate
+    for (size_t ivar=0; ivar<sums.size(); ++ivar) {
+        if (self->naccum == 0) sums[ivar] = *self->gcm_ovalsE[ivar];
+        else sums[ivar] += *self->gcm_ovalsE[ivar];
+    }
+    ++self->naccum;
+
+    if (self->naccum < self->couple_every) return false;
+
+    // End of averaging window: average in place, and couple.
+    std::vector<blitz::Array<double,3> const *> gcm_ovalsE;
+    double const by_naccum = 1. / (double)self->naccum;
+    for (auto &sum : sums) {
+        sum *= by_naccum;
+        gcm_ovalsE.push_back(&sum);
+    }
+    self->naccum = 0;
+
+    couple_native(self, itime, true, gcm_ovalsE,
+        E1vE0c_indices_p, E1vE0c_values_p, E1vE0c_nele);
+    return true;
 }
 // =======================================================
 
 /** Called from MPI rank.  Copies output of coupling back into
-appropriate dense-indexing ModelE variables. */
+appropriate dense-indexing ModelE variables.  out holds only the cells
+this rank owns (see split_by_domain()), so only those are written. */
 void GCMCoupler_ModelE::apply_gcm_ivals(GCMInput const &out)
 {
     printf("BEGIN GCMCoupler_ModelE::apply_gcm_ivals\n");
@@ -1179,9 +1602,13 @@ bool run_ice)    // if false, only initialize
     // Nothing more to do unless we're root
     if (!gcm_params.am_i_root()) return out;
 
-    // Run update_topo()
+    // Run update_topo(); unless every ice sheet reused its regrid
+    // matrices, in which case the TOPO fields would not change either.
+    bool rebuilt = !run_ice;
+    for (auto &ice_coupler : ice_couplers) rebuilt = rebuilt || ice_coupler->regrids_rebuilt;
+
     TupleListLT<1> wEAm_base;  // set by update_topo()
-    {
+    if (rebuilt) {
         std::vector<blitz::Array<double,1>> emI_lands, emI_ices;
         emI_ices.reserve(ice_couplers.size());
         emI_lands.reserve(ice_couplers.size());
@@ -1203,6 +1630,12 @@ bool run_ice)    // if false, only initialize
         auto one_dims(get_or_add_dims(ncio, {"one"}, {1}));
         NcVar info_var = get_or_add_var(ncio, "info", ibmisc::get_nc_type<double>(), one_dims);
         info_var.putAtt("notes", "Elevation classes (HC) are just those known to IceBin.  No legacy or sea-land elevation classes included.");
+        for (auto &ice_coupler : ice_couplers) {
+            // Error bound when regrid matrices / TOPO were reused
+            auto const &drift(ice_coupler->elevmask_drift);
+            info_var.putAtt(ice_coupler->name() + ".max_delev", netCDF::ncDouble, drift.max_delev);
+            info_var.putAtt(ice_coupler->name() + ".ncross", netCDF::ncInt, (int)drift.ncross);
+        }
         ncio_gcm_input(ncio, out, timespan, time_unit, "");
         ncio();
     }
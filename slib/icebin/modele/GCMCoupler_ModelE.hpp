@@ -18,6 +18,7 @@
 
 #pragma once
 
+#include <functional>
 #include <boost/mpi.hpp>
 #include <ibmisc/f90blitz.hpp>
 #include <icebin/GCMCoupler.hpp>
@@ -58,27 +59,86 @@ struct ModelEParams
 // ---------------------------------------------
 
 
+/** Tells which MPI rank owns each grid cell.  The owner of each A
+grid cell is looked up in a table, so any decomposition supplied by the
+GCM (latitude bands, 2-D blocks, or something irregular) may be used.
+Works for A and E grids. */
 class DomainDecomposer_ModelE {
-    ibmisc::Domain domainA_global;
     size_t ndomain;
-    blitz::Array<int,1> rank_of_j;    // indexing base=1
+    /** MPI rank of each A grid cell, indexed by iA = j*im + i (zero-based) */
+    std::vector<int> rank_of_iA;
 public:
 
-    DomainDecomposer_ModelE(std::vector<int> const &endj, ibmisc::Domain const &_domainA_global);
+    /** @param _rank_of_iA MPI rank of each A grid cell; indexed by iA.
+    @param _ndomain Number of MPI ranks */
+    DomainDecomposer_ModelE(std::vector<int> &&_rank_of_iA, size_t _ndomain);
 
     /** Number of domains */
     size_t size() const { return ndomain; }
 
     /** Returns the MPI rank of grid cell.  Works if ix is iA (atmosphere grid) or iE (elevation grid) */
     int get_domain(long ix) const {    // zero-based
-        auto im_world(domainA_global[0].end);
-        auto jm_world(domainA_global[1].end);
-
-        int j = (ix / im_world) % jm_world;    // +0 for 0-based indexing
-        return rank_of_j(j);
+        long const nA = rank_of_iA.size();
+        return rank_of_iA[ix < nA ? ix : ix % nA];    // iE = ihc*nA + iA
     }
 };
 
+/** @return true if the blocks cover every cell of the A grid exactly
+once; i.e. they can serve as the owner map (see rank_of_iA_from_blocks()).
+@param domains Block held by each MPI rank (zero-based, open ranges)
+@param domainA_global The entire A grid */
+extern bool blocks_partition(
+    std::vector<ibmisc::Domain> const &domains,
+    ibmisc::Domain const &domainA_global);
+
+/** Computes the owner map for a decomposition in which each MPI rank
+owns a rectangular block of the A grid (latitude bands, 2-D blocks).
+@param domains Block owned by each MPI rank (zero-based, open ranges)
+@param domainA_global The entire A grid
+@return MPI rank of each A grid cell; indexed by iA = j*im + i */
+extern std::vector<int> rank_of_iA_from_blocks(
+    std::vector<ibmisc::Domain> const &domains,
+    ibmisc::Domain const &domainA_global);
+
+/** Checks an owner map supplied by the GCM against the blocks in
+which each MPI rank holds its arrays.  Blocks may overlap (eg: halos)
+and need not cover the grid; but each rank reads and writes its owned
+cells through its own arrays, so every cell must lie within the block
+of the rank that owns it.  Raises an error if not, or if a rank number
+is out of range.
+@param rank_of_iA MPI rank of each A grid cell; indexed by iA = j*im + i
+@param domains Block held by each MPI rank (zero-based, open ranges)
+@param domainA_global The entire A grid */
+extern void check_rank_of_iA(
+    std::vector<int> const &rank_of_iA,
+    std::vector<ibmisc::Domain> const &domains,
+    ibmisc::Domain const &domainA_global);
+
+/** @return The A grid cells (iA = j*im + i) owned by one MPI rank,
+in increasing order.
+@param rank_of_iA MPI rank of each A grid cell */
+extern std::vector<long> owned_cells(
+    std::vector<int> const &rank_of_iA, int rank);
+
+/** Creates the ModelE regridder (and its EOpvAOp_base) on top of an
+ocean-grid regridder.
+@param global_ecO_fname File with the global elevation classes; "" for none
+@param share If set, return the copy already made by another coupler
+    in this process for the same (global_ecO_fname, gcmO), if any.  See
+    GCMParams::share_regridders. */
+extern std::shared_ptr<GCMRegridder_ModelE> get_modele_regridder(
+    std::string const &global_ecO_fname,
+    std::shared_ptr<GCMRegridder_Standard> const &gcmO,
+    bool share);
+
+/** Splits the (global) output of coupling on root into one GCMInput
+per MPI rank.
+@param domainsA, domainsE Owner of each A and E gridcell */
+extern std::vector<GCMInput> split_by_domain(
+    GCMInput const &out,
+    DomainDecomposer_ModelE const &domainsA,
+    DomainDecomposer_ModelE const &domainsE);
+
 #if 0
 struct GCMInput_ModelE : public GCMInput
 {
@@ -103,6 +163,11 @@ struct GCMInput_ModelE : public GCMInput
 #endif
 
 
+/** Phases of one coupling step in gcmce_couple_native(), in order.
+On ranks other than root, only GATHER, COUPLE, SCATTER and APPLY do
+anything (GATHER and SCATTER include waiting for root). */
+enum class CouplePhase { PACK, GATHER, COUPLE, SPLIT, COMPACT, SCATTER, APPLY, COUNT };
+
 class GCMCoupler_ModelE : public GCMCoupler
 {
 public:
@@ -113,10 +178,40 @@ public:
     Works for A and E grids. */
     std::unique_ptr<DomainDecomposer_ModelE> domains;
 
+    /** On root: block of the A grid held by each MPI rank (as passed
+    to gcmce_new()) */
+    std::vector<ibmisc::Domain> domain_blocks;
+
+    /** A grid cells owned by this MPI rank (iA = j*im + i), in
+    increasing order.  gcm_ovalsE is packed, and gcm_ivals applied,
+    for these cells only.  Valid once have_owner_map is set. */
+    std::vector<long> owned_iA;
+    bool have_owner_map = false;
+
+    /** On root: E1vE0c last scattered to each MPI rank; used to leave
+    it off the wire when it has not changed. */
+    std::vector<spsparse::TupleList<int,double,2>> E1vE0c_sent;
+
+    // ================== Optional instrumentation of gcmce_couple_native()
+    // (eg: modele/couple_bench.cpp); unset in production.
+    // Called after each phase, with its wall time on this rank [s]
+    std::function<void(CouplePhase, double)> on_phase;
+    // Called on every rank with its own packed gcm_ovalsE, just
+    // before the gather
+    std::function<void(VectorMultivec const &)> on_gather;
+
     // ================== ModelE Outputs
     // gcm_ovalsE[ovar](i, j, ihc)    Fortran-order 1-based indexing
     std::vector<std::unique_ptr<blitz::Array<double,3>>> gcm_ovalsE;
 
+    // ================== Time averaging of ModelE outputs
+    // Used when the GCM calls gcmce_accumulate_native() every timestep,
+    // and coupling happens only every couple_every timesteps.
+    int couple_every = 1;    // Number of timesteps in each averaging window
+    int naccum = 0;          // Timesteps summed so far in this window
+    // Running sum of gcm_ovalsE; same shape and indexing as gcm_ovalsE
+    std::vector<blitz::Array<double,3>> gcm_ovalsE_sum;
+
     // ================== ModelE Inputs
     // Variables borrowed from ModelE, used to return data to it.
     // All these variables are Fortran-order, 1-based indexing
@@ -158,8 +253,9 @@ public:
     /** Merge mask from last timestep */
     blitz::Array<int16_t,2> mergemaskA0;
 
-    /** E1vE0 in a form Fortran can digest */
-    VectorSparse<int,double,2> E1vE0c;
+    /** E1vE0 in a form Fortran can digest: index columns are
+    i, j, ihc1, ihc0 (1-based) */
+    VectorSparseSoA<int,double,4> E1vE0c;
     // ========================
 
 public:
@@ -206,6 +302,12 @@ public:
 
     int _read_nhc_gcm();
 
+    /** Installs the owner map: on root, checks it (check_rank_of_iA())
+    and builds domains; on every rank, sets owned_iA.  Called from all
+    MPI ranks; only root's rank_of_iA is used.
+    @param rank_of_iA MPI rank owning each A grid cell; indexed by iA */
+    void set_rank_of_iA(std::vector<int> &&rank_of_iA);
+
     /** Copies GCM inputs back to original GCM-supplied sparse input arrays */
     void apply_gcm_ivals(GCMInput const &out);
 
@@ -218,6 +320,13 @@ public:
 
 };    // class GCMCouler_ModelE
 
+/** On root: prepares the output of split_by_domain() for
+boost::mpi::scatter(), as done by gcmce_couple_native().  Marks each
+rank's E1vE0c as unchanged if it is the same as last sent (and
+records it in self->E1vE0c_sent), and sets the wire precision. */
+extern void compact_for_scatter(GCMCoupler_ModelE *self,
+    std::vector<GCMInput> &every_outs, bool run_ice);
+
 // ===============================================================
 // The "gcmce_*" interface used by Fortran ModelE
 // These headers are NOT needed, they are repeated in api_f.f90
@@ -236,6 +345,23 @@ GCMCoupler_ModelE *gcmce_new(
     // MPI Stuff
     MPI_Fint comm_f, int root);
 
+/** Creates one member of an in-process ensemble; members loading the
+same grid files share their regridders (see GCMParams::share_regridders). */
+extern "C"
+GCMCoupler_ModelE *gcmce_new_member(
+    ModelEParams const &_rdparams,
+    int im, int jm,
+    int i0_f, int i1_f, int j0_f, int j1_f,
+    MPI_Fint comm_f, int root,
+    char const *config_fname_f, int config_fname_len);
+
+/** Sets the owner of each grid cell; required if the blocks passed to
+gcmce_new() overlap or leave gaps.  Called from all MPI ranks; only
+root's array is used.
+@param rank_of_ij_f(im,jm) MPI rank owning each grid cell (Fortran order) */
+extern "C"
+void gcmce_set_domain_decomposition(GCMCoupler_ModelE *self, int const *rank_of_ij_f);
+
 /* Tells ModelE how many elevation classes it needs **/
 extern "C"
 void gcmce_hc_params(GCMCoupler_ModelE *self, int &nhc_gcm, int &icebin_base_hc, int &nhc_ice);
@@ -320,5 +446,26 @@ double **E1vE0c_values_p,
 int *E1vE0c_nele);
 
 
-}}
+extern "C"
+void gcmce_set_couple_every(GCMCoupler_ModelE *self, int nstep);
 
+extern "C"
+void gcmce_set_rebuild_tolerance(GCMCoupler_ModelE *self, double max_delev, int max_ncross);
+
+extern "C"
+void gcmce_set_audit(GCMCoupler_ModelE *self, bool audit);
+
+extern "C"
+void gcmce_set_scatter_float(GCMCoupler_ModelE *self, bool scatter_float);
+
+extern "C"
+void gcmce_set_compress_held_matrices(GCMCoupler_ModelE *self, bool compress);
+
+extern "C"
+bool gcmce_accumulate_native(GCMCoupler_ModelE *self,
+int itime,
+int **E1vE0c_indices_p,
+double **E1vE0c_values_p,
+int *E1vE0c_nele);
+
+}}
@@ -66,10 +66,10 @@ static AbbrGrid make_agridA(
     // Use hntr to figure out which grid cells should be realized in A, based
     // on realized grid cells in O
     SparseSet<long,int> dimA;
-    Hntr hntrOvA(17.17, hspecO, hspecA, 0);
-    HntrGrid const &hgridA(hntrOvA.Bgrid);
+    auto hntrOvA(hntr_plan(17.17, hspecO, hspecA, 0));
+    HntrGrid const &hgridA(hntrOvA->Bgrid);
     AbbrGrid agridA;
-    hntrOvA.overlap(
+    hntrOvA->overlap(
             accum::SparseSetAccum<SparseSetT,double,2>({nullptr, &dimA}),
         1.0, DimClip(&dimO));
 
@@ -103,12 +103,12 @@ static std::unique_ptr<linear::Weighted_Eigen> compute_AOmvAAm(
     GridSpec_LonLat const &specO(gcmA->specO());
     GridSpec_LonLat const &specA(gcmA->specA());
 
-    Hntr hntr_XOmvXAm(17.17, specO.hntr, specA.hntr);
+    auto hntr_XOmvXAm(hntr_plan(17.17, specO.hntr, specA.hntr));
 
     std::unique_ptr<linear::Weighted_Eigen> ret(new linear::Weighted_Eigen(dims, true));    // conservative
     reset_ptr(ret->M, MakeDenseEigenT(
         std::bind(&Hntr::overlap<MakeDenseEigenT::AccumT,DimClip>,
-            &hntr_XOmvXAm, _1, specA.eq_rad, DimClip(&dimAOm)),
+            hntr_XOmvXAm.get(), _1, specA.eq_rad, DimClip(&dimAOm)),
         {SparsifyTransform::TO_DENSE_IGNORE_MISSING, SparsifyTransform::ADD_DENSE},
         {&dimAOm, &dimAAm}, transpose).to_eigen());
 
@@ -258,10 +258,10 @@ ComputeXAmvGp_Helper::ComputeXAmvGp_Helper(
         SparseSetT &dimAAm(dimXAm);
 
         // Actually AOmvAAm
-        Hntr hntr_XOmvXAm(17.17, hntrO, hntrA);
+        auto hntr_XOmvXAm(hntr_plan(17.17, hntrO, hntrA));
         reset_ptr(XAmvXOm, MakeDenseEigenT(
             std::bind(&Hntr::overlap<MakeDenseEigenT::AccumT,DimClip>,
-                &hntr_XOmvXAm, _1, eq_rad, DimClip(&dimAOm)),
+                hntr_XOmvXAm.get(), _1, eq_rad, DimClip(&dimAOm)),
             {SparsifyTransform::TO_DENSE_IGNORE_MISSING, SparsifyTransform::ADD_DENSE},
             {&dimAOm, &dimAAm}, 'T').to_eigen());
     }
@@ -441,6 +441,11 @@ GCMRegridder_ModelE::GCMRegridder_ModelE(
     std::shared_ptr<icebin::GCMRegridder_Standard> const &_gcmO)
     :  global_ecO(_global_ecO), gcmO(_gcmO)
 {
+    // elevE, underice and TOPO merging all use the single list
+    // gcmO->hcdefs(); they would disagree with GvEp's per-cell lists.
+    if (gcmO->hcdefsA_offsets.size() > 0) (*icebin_error)(-1,
+        "GCMRegridder_ModelE does not support per-A-cell elevation classes (hcdefsA)");
+
     // Initialize superclass member
     mem_agridA.reset(new AbbrGrid(make_agridA(*gcmO->agridA)));
     agridA = &*mem_agridA;
@@ -654,9 +659,9 @@ linear::Weighted_Tuple GCMRegridder_ModelE::global_AvE(
 
 // ==============================================================
 
-void GCMRegridder_WrapE::_init(std::unique_ptr<GCMRegridder_ModelE> &&_gcmA)
+void GCMRegridder_WrapE::_init(std::shared_ptr<GCMRegridder_ModelE> const &_gcmA)
 {
-    gcmA = std::move(_gcmA);
+    gcmA = _gcmA;
     _ice_regridders = &gcmA->ice_regridders();
 
     // Copy assorted stuff over
@@ -668,9 +673,9 @@ void GCMRegridder_WrapE::_init(std::unique_ptr<GCMRegridder_ModelE> &&_gcmA)
 }
 
 
-GCMRegridder_WrapE::GCMRegridder_WrapE(std::unique_ptr<GCMRegridder_ModelE> &&_gcmA)
+GCMRegridder_WrapE::GCMRegridder_WrapE(std::shared_ptr<GCMRegridder_ModelE> const &_gcmA)
 {
-    _init(std::move(_gcmA));
+    _init(_gcmA);
 
     auto const nO = gcmA->gcmO->nA();
     foceanOp.reference(blitz::Array<double,1>(nO));
@@ -678,12 +683,12 @@ GCMRegridder_WrapE::GCMRegridder_WrapE(std::unique_ptr<GCMRegridder_ModelE> &&_g
 }
 
 GCMRegridder_WrapE::GCMRegridder_WrapE(
-    std::unique_ptr<GCMRegridder_ModelE> &&_gcmA,
+    std::shared_ptr<GCMRegridder_ModelE> const &_gcmA,
     blitz::Array<double,1> _foceanOp,
     blitz::Array<double,1> _foceanOm)
 : foceanOp(_foceanOp), foceanOm(foceanOm)
 {
-    _init(std::move(_gcmA));
+    _init(_gcmA);
 }
 
 
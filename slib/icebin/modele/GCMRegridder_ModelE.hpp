@@ -205,7 +205,9 @@ public:
 
 class GCMRegridder_WrapE : public GCMRegridder {
 public:
-    std::unique_ptr<GCMRegridder_ModelE> gcmA;
+    /** May be shared among ensemble members (see GCMParams::share_regridders);
+    per-member state (foceanOp, foceanOm) lives in this class. */
+    std::shared_ptr<GCMRegridder_ModelE> gcmA;
 
     /** ModelE ocean cover, on the Ocean grid, as seen by the ice
     model (sparse indexing).  Ocean grid cells can contain fractional
@@ -223,13 +225,13 @@ public:
 
 
 private:
-    void _init(std::unique_ptr<GCMRegridder_ModelE> &&_gcmA);
+    void _init(std::shared_ptr<GCMRegridder_ModelE> const &_gcmA);
 public:
 
-    GCMRegridder_WrapE(std::unique_ptr<GCMRegridder_ModelE> &&_gcmA);
+    GCMRegridder_WrapE(std::shared_ptr<GCMRegridder_ModelE> const &_gcmA);
 
     GCMRegridder_WrapE(
-        std::unique_ptr<GCMRegridder_ModelE> &&_gcmA,
+        std::shared_ptr<GCMRegridder_ModelE> const &_gcmA,
         blitz::Array<double,1> _foceanOp,
         blitz::Array<double,1> _foceanOm);
 
@@ -42,8 +42,9 @@ end type ModelEParams_t
 ! Represents a sparse matrix as a set of vectors
 type :: VectorSparse_t
     ! indices of row and col in whatever form is desired for a particular purpose
-    ! There could be 2 or more indices per value
-    integer(c_int), pointer :: indices(:)
+    ! indices(n,:) are the indices of element n; each column is contiguous.
+    ! For E1vE0: indices(n,:) = (i, j, ihc1, ihc0)
+    integer(c_int), pointer :: indices(:,:)
     ! Value of non-zero elements
     real(c_double), pointer :: values(:)
 contains
@@ -75,6 +76,33 @@ INTERFACE
         integer(c_int), value :: comm_f, root
     end function gcmce_new
 
+    ! Creates one member of an ensemble run in a single process;
+    ! members share regridders loaded from the same files.
+    function gcmce_new_member( &
+        rdparams, &
+        im,jm, &
+        i0,i1,j0,j1, &
+        comm_f, root, &
+        config_fname_f, config_fname_len) bind(c)
+    use iso_c_binding
+    import ModelEParams_t
+        type(c_ptr) :: gcmce_new_member
+        type(ModelEParams_t) :: rdparams
+        integer(c_int), value :: im, jm
+        integer(c_int), value :: i0,i1,j0,j1
+        integer(c_int), value :: comm_f, root
+        character(c_char) :: config_fname_f(*)
+        integer(c_int), value :: config_fname_len
+    end function gcmce_new_member
+
+
+    ! Called after gcmce_new() by all ranks; required if the ranks'
+    ! blocks overlap (eg: halos) or leave gaps
+    subroutine gcmce_set_domain_decomposition(api, rank_of_ij) bind(c)
+    use iso_c_binding
+        type(c_ptr), value :: api
+        integer(c_int) :: rank_of_ij(*)
+    end subroutine gcmce_set_domain_decomposition
 
     ! Called from lisheeticebin%allocate() (via setup_gcm_inputs)
     subroutine gcmce_hc_params(api, nhc_gcm, icebin_base_hc, nhc_ice) bind(c)
@@ -201,6 +229,55 @@ INTERFACE
         integer :: E1vE0c_nele
     end subroutine
 
+    ! Optional: Number of timesteps to average for each coupling
+    subroutine gcmce_set_couple_every(api, nstep) bind(c)
+    use iso_c_binding
+        type(c_ptr), value :: api
+        integer(c_int), value :: nstep
+    end subroutine
+
+    ! Optional: Reuse regrid matrices while elevations change little
+    subroutine gcmce_set_rebuild_tolerance(api, max_delev, max_ncross) bind(c)
+    use iso_c_binding
+        type(c_ptr), value :: api
+        real(c_double), value :: max_delev
+        integer(c_int), value :: max_ncross
+    end subroutine
+
+    ! Optional: Record conservation budgets of each regrid
+    subroutine gcmce_set_audit(api, audit) bind(c)
+    use iso_c_binding
+        type(c_ptr), value :: api
+        logical(c_bool), value :: audit
+    end subroutine
+
+    ! Optional: Send coupler outputs to MPI ranks in single precision
+    subroutine gcmce_set_scatter_float(api, scatter_float) bind(c)
+    use iso_c_binding
+        type(c_ptr), value :: api
+        logical(c_bool), value :: scatter_float
+    end subroutine
+
+    ! Optional: Keep IvE0 and XuE0 compressed on root between coupling steps
+    subroutine gcmce_set_compress_held_matrices(api, compress) bind(c)
+    use iso_c_binding
+        type(c_ptr), value :: api
+        logical(c_bool), value :: compress
+    end subroutine
+
+    ! Called every timestep in place of gcmce_couple_native();
+    ! returns .true. on timesteps when coupling took place.
+    function gcmce_accumulate_native(api, itime, &
+        E1vE0c_indices, E1vE0c_values, E1vE0c_nele) bind(c)
+    use iso_c_binding
+        logical(c_bool) :: gcmce_accumulate_native
+        type(c_ptr), value :: api
+        integer(c_int), value :: itime
+        type(c_ptr) :: E1vE0c_indices
+        type(c_ptr) :: E1vE0c_values
+        integer :: E1vE0c_nele
+    end function
+
     subroutine gcmce_model_start(api, cold_start, yeari, itimei, dtsrc) bind(c)
         use iso_c_binding
         type(c_ptr), value :: api
@@ -223,7 +300,7 @@ subroutine from_c(self, indices_c, values_c, nnz)
 
     ! Convert E1vE0 matrix, returned by gcmce_couple_native(), to
     ! Fortran arrays.
-    call c_f_pointer(indices_c, self%indices, [nnz*4])
+    call c_f_pointer(indices_c, self%indices, [nnz,4])
     call c_f_pointer(values_c, self%values, [nnz])
 end subroutine
 
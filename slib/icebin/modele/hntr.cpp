@@ -1,4 +1,9 @@
 #include <cmath>
+#include <map>
+#include <mutex>
+#include <tuple>
+#include <cstdint>
+#include <cstring>
 #include <icebin/error.hpp>
 #include <icebin/modele/hntr.hpp>
 //#include <icebin/modele/hntr_templates.hpp>
@@ -30,6 +35,29 @@ void HntrGrid::init()
     dxyp.reference(make_dxyp(spec, blitz::fortranArray));
 }
 
+blitz::Array<double,1> make_sinb(HntrSpec const &spec)
+{
+    // Convert minutes to radians
+    const double MIN_TO_RAD = (2. * M_PI) / (360*60);
+
+    blitz::Array<double,1> sinb(Range(0, spec.jm));
+    if (spec.uniform_lat()) {
+        // Domain is measured in minutes (1/60-th of a degree)
+        double FJEQ = .5*(1+spec.jm);
+        for (int J=1; J <= spec.jm-1; ++J) {
+            double RJ = (J + .5-FJEQ) * spec.dlat;  //  latitude in minutes of northern edge
+            sinb(J) = sin(RJ * MIN_TO_RAD);
+        }
+    } else {
+        for (int J=1; J <= spec.jm-1; ++J) {
+            sinb(J) = sin(spec.latb[J] * (M_PI / 180.));
+        }
+    }
+    sinb(0) = -1;
+    sinb(spec.jm) = 1;
+    return sinb;
+}
+
 blitz::Array<double,1> make_dxyp(
     HntrSpec const &spec,
     blitz::GeneralArrayStorage<1> const &storage)
@@ -41,6 +69,16 @@ blitz::Array<double,1> make_dxyp(
     // Calculate the sperical area of grid cells
     // (on a radius=1 sphere)
     double dLON = (2.*M_PI) / spec.im;
+
+    if (!spec.uniform_lat()) {
+        // Exact spherical band areas between the given boundaries
+        blitz::Array<double,1> sinb(make_sinb(spec));
+        for (int j=1; j<=spec.jm; ++j) {
+            dxyp(j-1+dxyp.lbound(0)) = dLON * (sinb(j) - sinb(j-1));
+        }
+        return dxyp;
+    }
+
     double dLAT = M_PI / jm;
     for (int j=1; j<=spec.jm; ++j) {
         double SINS = sin(dLAT*(j-jm/2-1));
@@ -77,6 +115,26 @@ Hntr::Hntr(double yp17, HntrSpec const &_Bgrid, HntrSpec const &_Agrid, double _
 
     partition_east_west();
     partition_north_south();
+    aligned = compute_aligned();
+    block_fast_path = aligned;
+}
+
+/** Grid B is a coarsening of grid A by integer ratios, with edges
+that coincide exactly.  Checked on the partition tables rather than
+the specs, so round-off in the edge positions can never make the
+fast path disagree with the general one. */
+bool Hntr::compute_aligned() const
+{
+    if (Agrid.spec.im % Bgrid.spec.im != 0) return false;
+    if (Agrid.spec.jm < Bgrid.spec.jm) return false;
+
+    for (int IB=1; IB <= Bgrid.spec.im; ++IB) {
+        if (FMIN(IB) != 0 || FMAX(IB) != 0) return false;
+    }
+    for (int JB=1; JB <= Bgrid.spec.jm; ++JB) {
+        if (GMIN(JB) != 0 || GMAX(JB) != 0) return false;
+    }
+    return true;
 }
 
 // Partitions in east-west (I) direction
@@ -117,28 +175,11 @@ void Hntr::partition_east_west()
 
 void Hntr::partition_north_south()
 {
-    // Convert minutes to radians
-    const double MIN_TO_RAD = (2. * M_PI) / (360*60);
-
     // ------------------------------------------------
     // Partitions in the north-south (J) direction
-    // Domain is measured in minutes (1/60-th of a degree)
-    double FJEQA = .5*(1+Agrid.spec.jm);
-    for (int JA=1; JA <= Agrid.spec.jm-1; ++JA) {
-        double RJA = (JA + .5-FJEQA) * Agrid.spec.dlat;  //  latitude in minutes of northern edge
-        SINA(JA) = sin(RJA * MIN_TO_RAD);
-    }
-    SINA(0) = -1;
-    SINA(Agrid.spec.jm)=  1;
-
-    // -----------
-    double FJEQB = .5*(1+Bgrid.spec.jm);
-    for (int JB=1; JB <= Bgrid.spec.jm-1; ++JB) {
-        double RJB = (JB+.5-FJEQB)*Bgrid.spec.dlat;  //  latitude in minutes of northern edge
-        SINB(JB) = sin(RJB * MIN_TO_RAD);
-    }
-    SINB(0) = -1;
-    SINB(Bgrid.spec.jm) = 1;
+    // (uniform or explicit latitude boundaries; see make_sinb())
+    SINA = make_sinb(Agrid.spec);
+    SINB = make_sinb(Bgrid.spec);
 
     // -----------
     JMIN(1) = 1;
@@ -228,6 +269,41 @@ void Hntr::mean_polar_matrix()
 
 
 
+// -------------------------------------------------------------
+namespace {
+
+// yp17 and DATMIS are keyed on their bit patterns, so that NaN
+// (often used for DATMIS) orders properly.
+typedef std::tuple<HntrSpec, HntrSpec, uint64_t, uint64_t> HntrPlanKey;
+
+uint64_t double_bits(double x)
+{
+    uint64_t ret;
+    memcpy(&ret, &x, sizeof(ret));
+    return ret;
+}
+
+/** Plans constructed so far.  Held strongly: a plan is only O(im+jm)
+in size, and callers often construct one, use it and drop it. */
+std::mutex plans_mutex;
+std::map<HntrPlanKey, std::shared_ptr<Hntr const>> plans;
+
+}    // anonymous namespace
+
+std::shared_ptr<Hntr const> hntr_plan(
+    double yp17, HntrSpec const &_B, HntrSpec const &_A, double _DATMIS)
+{
+    HntrPlanKey const key(_A, _B, double_bits(yp17), double_bits(_DATMIS));
+
+    std::lock_guard<std::mutex> lock(plans_mutex);
+    auto ii(plans.find(key));
+    if (ii != plans.end()) return ii->second;
+
+    std::shared_ptr<Hntr const> plan(new Hntr(yp17, _B, _A, _DATMIS));
+    plans.insert(std::make_pair(key, plan));
+    return plan;
+}
+
 // -------------------------------------------------------------
 HntrSpec make_hntrA(HntrSpec const &hntrO)
 {
@@ -237,6 +313,11 @@ HntrSpec make_hntrA(HntrSpec const &hntrO)
 
     // --------------------------
     // Define Atmosphere grid to be exactly twice the Ocean grid
+    if (!hntrO.uniform_lat()) {
+        std::vector<double> latb;
+        for (size_t j=0; j<hntrO.latb.size(); j += 2) latb.push_back(hntrO.latb[j]);
+        return HntrSpec(hntrO.im/2, hntrO.offi*0.5, std::move(latb));
+    }
     return HntrSpec(hntrO.im/2, hntrO.jm/2, hntrO.offi*0.5, hntrO.dlat*2.);
 }
 
@@ -1,6 +1,9 @@
 #ifndef ICEBIN_HNTR_HPP
 #define ICEBIN_HNTR_HPP
 
+#include <vector>
+#include <memory>
+#include <algorithm>
 #include <ibmisc/blitz.hpp>
 #include <ibmisc/indexing.hpp>
 #include <icebin/eigen_types.hpp>
@@ -9,6 +12,10 @@
 namespace icebin {
 namespace modele {
 
+/** Sine of latitude of the cell boundaries of a grid, south to north.
+@return Array indexed 0..jm; sinb(0)=-1, sinb(jm)=1. */
+extern blitz::Array<double,1> make_sinb(HntrSpec const &spec);
+
 extern blitz::Array<double,1> make_dxyp(
     HntrSpec const &spec,
     blitz::GeneralArrayStorage<1> const &storage = blitz::GeneralArrayStorage<1>());
@@ -31,7 +38,8 @@ protected:
     void init();    // Use after constructor or ncio()
 
 public:
-    /** Area of grid cell at lattitude index = j.
+    /** Area of grid cell at lattitude index = j.  Exact band
+    areas if the spec has explicit latitude boundaries.
     @param j One-based indexing. */
     blitz::Array<double,1> dxyp;
 
@@ -87,6 +95,16 @@ public:
     // cell (IB,JB) has integrated value 0 of WTA
     double DATMIS;
 
+    // True if every B cell is made of whole A cells: the grid
+    // spacings are integer multiples and the edges line up
+    // (all of FMIN, FMAX, GMIN and GMAX are 0).  Set by the constructor.
+    bool aligned;
+
+    // Use the block-sum kernels in regrid() and matrix() (and so
+    // overlap() and scaled_regrid_matrix()) when the grids are aligned.
+    // Set to false to force the general path (for testing).
+    bool block_fast_path;
+
 public:
 
 
@@ -141,6 +159,18 @@ public:
 private:
     void partition_east_west();
     void partition_north_south();
+    bool compute_aligned() const;
+
+    /** Regrids aligned grids (see Hntr::aligned).  Each B cell is a
+    block of whole A cells, so no partial-cell fractions are needed:
+    rows of A are summed contiguously, then scaled by the exact area
+    weight of the row. */
+    template<class WeightT, class SrcT, class DestT>
+    void regrid_aligned(
+        blitz::Array<WeightT,1> const &WTA,
+        blitz::Array<SrcT,1> const &A,
+        blitz::Array<DestT,1> &B,
+        double wtm, double wtb) const;
 
     // Default function argument for overlap() template below
     template<typename Typ, bool Val>
@@ -158,6 +188,15 @@ private:
         MatAccumT &&mataccum,        // The output (sparse) matrix; 0-based indexing
         IncludeT includeB) const;
 
+    /** matrix() for aligned grids (see Hntr::aligned).  Visits the
+    same A cells in the same order as the general path, but with no
+    partial-cell fractions: every F is 1, and the I range is split
+    into contiguous runs instead of wrapping each index. */
+    template<class MatAccumT, class IncludeT>
+    void matrix_aligned(
+        MatAccumT &mataccum,
+        IncludeT &includeB) const;
+
 public:
     /** Generates the overlap matrix between two Hntr grids.
     An overlap matrix gives the area of the overlap of gridcells
@@ -173,16 +212,25 @@ public:
     void overlap(
         AccumT &&accum,        // The output (sparse) matrix; 0-based indexing
         double const eq_rad,        // Radius of the Earth
-        IncludeT includeB = IncludeT());
+        IncludeT includeB = IncludeT()) const;
 
     /** Produces a scaled regrid matrix, without the extra baggage.
     Equivalent to running overlap() and then scaling. */
     template<class AccumT, class IncludeT = IncludeConst<int,true>>
     void scaled_regrid_matrix(
         AccumT &&accum,        // The output (sparse) matrix; 0-based indexing
-        IncludeT includeB = IncludeT());
+        IncludeT includeB = IncludeT()) const;
 };    // class Hntr
 
+/** Returns a Hntr for a pair of grids from a process-wide cache of
+plans, constructing it the first time it is asked for.  Plans are
+immutable, so they may be shared between callers (and threads).  Use
+in place of constructing a Hntr for grid pairs that are regridded
+repeatedly (eg: make_topoA() on every coupling step).
+@param yp17, _B, _A, _DATMIS As in the Hntr constructor. */
+extern std::shared_ptr<Hntr const> hntr_plan(
+    double yp17, HntrSpec const &_B, HntrSpec const &_A, double _DATMIS=0.0);
+
 
 
 // --------------------------------------------------------------
@@ -206,6 +254,11 @@ void Hntr::matrix(
     MatAccumT &&mataccum,        // The output (sparse) matrix; 0-based indexing
     IncludeT includeB) const
 {
+    if (aligned && block_fast_path) {
+        matrix_aligned(mataccum, includeB);
+        return;
+    }
+
     // ------------------
     // Interpolate the A grid onto the B grid
     for (int JB=1; JB <= Bgrid.spec.jm; ++JB) {
@@ -243,6 +296,43 @@ void Hntr::matrix(
     }
 }
 
+template<class MatAccumT, class IncludeT>
+void Hntr::matrix_aligned(
+    MatAccumT &mataccum,
+    IncludeT &includeB) const
+{
+    int const imA = Agrid.spec.im;
+    int const imB = Bgrid.spec.im;
+
+    for (int JB=1; JB <= Bgrid.spec.jm; ++JB) {
+        int const JAMIN = JMIN(JB);
+        int const JAMAX = JMAX(JB);
+
+        for (int IB=1; IB <= imB; ++IB) {
+            int const IJB = IB + imB * (JB-1);
+            if (!includeB(IJB-1)) continue;
+
+            mataccum.clear();
+
+            int const IAMAX = IMAX(IB);
+            for (int JA=JAMIN; JA <= JAMAX; ++JA) {
+                double const G = SINA(JA) - SINA(JA-1);
+                int const IJA0 = imA * (JA-1);
+
+                for (int IAREV=IMIN(IB); IAREV <= IAMAX; ) {
+                    int const IA0 = 1 + ((IAREV-1) % imA);
+                    int const IA1 = IA0 + std::min(IAMAX-IAREV, imA-IA0);
+                    for (int IA=IA0; IA <= IA1; ++IA)
+                        mataccum.addA(IJA0+IA, G);
+                    IAREV += IA1 - IA0 + 1;
+                }
+            }
+
+            mataccum.finishB(IJB, JB);
+        }
+    }
+}
+
 
 // ----------------------------------------------------------
 template<class AccumT>
@@ -287,7 +377,7 @@ template<class AccumT, class IncludeT>
 void Hntr::overlap(
     AccumT &&accum,        // The output (sparse) matrix; 0-based indexing
     double const eq_rad,        // Radius of the Earth
-    IncludeT includeB)
+    IncludeT includeB) const
 {
     matrix(OverlapMatAccum<AccumT>(std::move(accum), Bgrid, eq_rad*eq_rad), includeB);
 }
@@ -331,7 +421,7 @@ public:
 template<class AccumT, class IncludeT>
 void Hntr::scaled_regrid_matrix(
     AccumT &&accum,        // The output (sparse) matrix; 0-based indexing
-    IncludeT includeB)
+    IncludeT includeB) const
 {
     matrix(
         ScaledRegridMatAccum<AccumT>(std::move(accum), Agrid),
@@ -382,6 +472,58 @@ public:
 };
 
 
+template<class WeightT, class SrcT, class DestT>
+void Hntr::regrid_aligned(
+    blitz::Array<WeightT,1> const &WTA,
+    blitz::Array<SrcT,1> const &A,
+    blitz::Array<DestT,1> &B,
+    double wtm, double wtb) const
+{
+    int const imA = Agrid.spec.im;
+    int const imB = Bgrid.spec.im;
+
+    // Per-IB accumulators for the current row of B
+    std::vector<double> WEIGHT(imB+1);
+    std::vector<double> VALUE(imB+1);
+
+    for (int JB=1; JB <= Bgrid.spec.jm; ++JB) {
+        std::fill(WEIGHT.begin(), WEIGHT.end(), 0.);
+        std::fill(VALUE.begin(), VALUE.end(), 0.);
+
+        for (int JA=JMIN(JB); JA <= JMAX(JB); ++JA) {
+            double const G = SINA(JA) - SINA(JA-1);
+            int const IJA0 = imA * (JA-1);
+
+            for (int IB=1; IB <= imB; ++IB) {
+                // IMAX(imB) runs past imA (wraps around the globe);
+                // split the range into contiguous runs, rather than
+                // taking Mod on every element.
+                int const IAMAX = IMAX(IB);
+                double w = 0;
+                double v = 0;
+                for (int IAREV=IMIN(IB); IAREV <= IAMAX; ) {
+                    int const IA0 = 1 + ((IAREV-1) % imA);
+                    int const IA1 = IA0 + std::min(IAMAX-IAREV, imA-IA0);
+                    for (int IA=IA0; IA <= IA1; ++IA) {
+                        double const wta = wtm * WTA(IJA0+IA) + wtb;
+                        w += wta;
+                        v += wta * A(IJA0+IA);
+                    }
+                    IAREV += IA1 - IA0 + 1;
+                }
+                WEIGHT[IB] += G * w;
+                VALUE[IB] += G * v;
+            }
+        }
+
+        for (int IB=1; IB <= imB; ++IB) {
+            int const IJB = IB + imB * (JB-1);
+            B(IJB) = (WEIGHT[IB] == 0 ? DATMIS : VALUE[IB] / WEIGHT[IB]);
+        }
+    }
+}
+
+
 template<class WeightT, class SrcT, class DestT, int RANK>
 void Hntr::regrid(
     blitz::Array<WeightT,RANK> const &_WTA,
@@ -406,9 +548,13 @@ void Hntr::regrid(
     }
 
 
-    matrix(
-        RegridAccum<WeightT,SrcT,DestT>(WTA, A, B, DATMIS, wtm, wtb),
-        IncludeConst<int,true>());
+    if (aligned && block_fast_path) {
+        regrid_aligned(WTA, A, B, wtm, wtb);
+    } else {
+        matrix(
+            RegridAccum<WeightT,SrcT,DestT>(WTA, A, B, DATMIS, wtm, wtb),
+            IncludeConst<int,true>());
+    }
 
     if (mean_polar) {
         // Replace individual values near the poles by longitudinal mean
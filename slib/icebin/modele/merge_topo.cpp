@@ -3,6 +3,7 @@
 #include <icebin/modele/topo.hpp>
 #include <icebin/modele/grids.hpp>
 #include <icebin/eigen_types.hpp>
+#include <icebin/error.hpp>
 #include <ibmisc/linear/compressed.hpp>
 #include <ibmisc/const.hpp>
 
@@ -25,6 +26,17 @@ public:
     blitz::Array<double,1> elev_areaO;     // Elevation [m] * Ice-covered Cell Area [m^2] = [m^3]
 };
 
+// ------------------------------------------------------------------------
+/** TOPO merging stacks the local ice sheets' single list of
+elevation classes (gcmO->hcdefs()) on top of the global ones; it has
+no notion of per-A-cell classes (GCMRegridder::hcdefsA_offsets). */
+static void check_no_hcdefsA(GCMRegridder_Standard const *gcmO, char const *where)
+{
+    if (gcmO->hcdefsA_offsets.size() > 0) (*icebin_error)(-1,
+        "%s: per-A-cell elevation classes (hcdefsA) are not supported "
+        "in ModelE TOPO merging", where);
+}
+
 // ------------------------------------------------------------------------
 /** Returns elevation on ocean grid (elevO) for a single local ice sheet.
 @param gcmO GCMRegridder
@@ -34,7 +46,7 @@ public:
     =elev or NaN; for either all land, or ice-covered land, depending
     on desired result. */
 static GetSheetElevO get_sheet_elevO(
-GCMRegridder_Standard *gcmO,
+GCMRegridder_Standard const *gcmO,
 RegridParams const &paramsO,
 int sheet_index,
 blitz::Array<double,1> const &elevmaskI)
@@ -101,18 +113,19 @@ blitz::Array<double,2> &zland_minO2,   // OUT only (will get this info from emI_
 blitz::Array<double,2> &zland_maxO2,    // OUT only
 blitz::Array<int16_t,2> &mergemaskOm2,   // OUT only.  Indicates where merging of local into global ice took place.  Only update these gridcells.
 // ------ Local ice sheets to merge in...
-GCMRegridder_Standard *gcmO,    // Multiple IceRegridders
+GCMRegridder_Standard const *gcmO,    // Multiple IceRegridders
 RegridParams const &paramsA,
 std::vector<blitz::Array<double,1>> const &emI_lands,  // em = elev_mask (dense indexing): elevation only for cells with ice+land
 std::vector<blitz::Array<double,1>> const &emI_ices,    // elevation only for cells with ice
 double const eq_rad,    // Radius of the earth
 std::vector<std::string> &errors)
 {
+    check_no_hcdefsA(gcmO, "merge_topoO()");
 
 #if 0
 // Log inputs for debugging
 {
-    auto &indexing(gcmO->ice_regridders()[0]->agridI.indexing);
+    auto &indexing(gcmO->ice_regridders()[0]->agridI().indexing);
     blitz::TinyVector<int,2> shapeI(indexing[1].extent, indexing[0].extent);
     auto emI_land2(unconst(reshape<double,1,2>(emI_lands[0], shapeI)));
     auto emI_ice2(unconst(reshape<double,1,2>(emI_ices[0], shapeI)));
@@ -386,6 +399,7 @@ Indexing const &indexingHC_base,
 bool squash_ecs,    // Should ECs be merged if they are the same elevation?
 std::vector<std::string> &errors)
 {
+    check_no_hcdefsA(gcmO, "compute_EOpvAOp_merged()");
     EOpvAOpResult ret;    // return variable
 
     // ======================= Create a merged EOpvAOp of base ice and ice sheets
@@ -52,7 +52,7 @@ blitz::Array<double,2> &zland_minO2,
 blitz::Array<double,2> &zland_maxO2,
 blitz::Array<int16_t,2> &mergemaskOm2,   // OUT only.  Indicates where merging of local into global ice took place.  Only update these gridcells.
 // ------ Local ice to merge in...
-GCMRegridder_Standard *gcmO,
+GCMRegridder_Standard const *gcmO,
 RegridParams const &paramsA,
 std::vector<blitz::Array<double,1>> const &emI_lands,
 std::vector<blitz::Array<double,1>> const &emI_ices,
@@ -0,0 +1,73 @@
+#include <map>
+#include <mutex>
+#include <tuple>
+#include <cstdio>
+#include <icebin/error.hpp>
+#include <icebin/modele/regridder_bundle.hpp>
+
+using namespace ibmisc;
+
+namespace icebin {
+namespace modele {
+
+// -------------------------------------------------------------
+namespace {
+
+typedef std::tuple<std::string, std::string, std::string> BundleKey;
+
+/** Bundles already loaded by this process.  Held weakly, so a bundle
+is freed once the last user is done with it. */
+std::mutex cache_mutex;
+std::map<BundleKey, std::weak_ptr<RegridderBundle const>> cache;
+
+}    // anonymous namespace
+// -------------------------------------------------------------
+
+std::shared_ptr<RegridderBundle const> load_regridder_bundle(
+    std::string const &global_ecO_fname,
+    std::string const &gcmO_fname,
+    std::string const &bundle_fname)
+{
+    std::lock_guard<std::mutex> lock(cache_mutex);
+
+    MappedSource const global_ecO_source(MappedSource::of(global_ecO_fname, "EvO.M"));
+    MappedSource const gcmO_source(MappedSource::of(gcmO_fname, "m"));
+
+    // 1. Already loaded in this process, from the same input files
+    BundleKey const key(global_ecO_source.fname, gcmO_source.fname, bundle_fname);
+    auto ii(cache.find(key));
+    if (ii != cache.end()) {
+        std::shared_ptr<RegridderBundle const> bundle(ii->second.lock());
+        if (bundle
+            && bundle->global_ecO_source == global_ecO_source
+            && bundle->gcmO_source == gcmO_source) return bundle;
+    }
+
+    std::shared_ptr<RegridderBundle> bundle(new RegridderBundle);
+    bundle->global_ecO_source = global_ecO_source;
+    bundle->gcmO_source = gcmO_source;
+
+    // 2. Small stuff from global_ec
+    printf("Reading %s\n", global_ecO_fname.c_str());
+    {NcIO ncio(global_ecO_fname, 'r');
+        bundle->metaO.ncio(ncio);
+        bundle->EOpvAOp_base.ncio(ncio, "EvO.M");
+    }
+
+    // 3. The GCMRegridder, mapped if possible
+    if (bundle_fname != "") {
+        printf("Reading %s via regridder bundle %s\n",
+            gcmO_fname.c_str(), bundle_fname.c_str());
+        bundle->gcmO = new_GCMRegridder_Mapped(gcmO_fname, "m", bundle_fname);
+    } else {
+        printf("Reading %s\n", gcmO_fname.c_str());
+        bundle->gcmO.reset(new GCMRegridder_Standard);
+        NcIO ncio(gcmO_fname, 'r');
+        bundle->gcmO->ncio(ncio, "m");
+    }
+
+    cache[key] = bundle;
+    return bundle;
+}
+
+}}    // namespace
@@ -0,0 +1,67 @@
+#ifndef ICEBIN_MODELE_REGRIDDER_BUNDLE_HPP
+#define ICEBIN_MODELE_REGRIDDER_BUNDLE_HPP
+
+#include <memory>
+#include <string>
+#include <ibmisc/netcdf.hpp>
+#include <ibmisc/zarray.hpp>
+#include <icebin/GCMRegridder.hpp>
+#include <icebin/GCMRegridder_Mapped.hpp>
+#include <icebin/modele/global_ec.hpp>
+
+/** Everything the TOPO-generation tools (make_merged_topoo, etc.)
+need to load before they can do any work: the base (global ice)
+EOpvAOp matrix written by global_ec, and the GCMRegridder for the
+local ice sheets.  Nearly all the load time is parsing the A grid and
+every exchange grid of the GCMRegridder; a topo workflow that runs
+these tools back to back would otherwise repeat that each time.
+
+Only the GCMRegridder goes in the bundle file.  EOpvAOp_base is read
+from global_ec on each (cold) load: it is stored there compressed, so
+that is one small read.  icebin22m (obsolete; not built) still builds
+its own atmosphere-grid regridder and does not use bundles. */
+
+namespace icebin {
+namespace modele {
+
+struct RegridderBundle {
+    /** Metadata from the global_ec output file */
+    global_ec::Metadata metaO;
+
+    /** Base EOpvAOp matrix (global ice only); sparse indexing. */
+    ibmisc::ZArray<int,double,2> EOpvAOp_base;
+
+    /** Regridder for the local ice sheets (ocean grid).  If loaded
+    through a bundle file, its large arrays are mapped from it. */
+    std::unique_ptr<GCMRegridder_Standard> gcmO;
+
+    /** The input files, as they were when the bundle was loaded */
+    MappedSource global_ecO_source;
+    MappedSource gcmO_source;
+};
+
+/** Loads a RegridderBundle, using a bundle file and an in-process
+cache to avoid re-parsing the inputs.
+
+ 1. If this process has already loaded the bundle for the same
+    input files (by name, size and mtime), the in-memory copy is
+    returned.
+ 2. Otherwise, metaO and EOpvAOp_base are read from global_ecO_fname;
+    these are small (EOpvAOp is stored compressed).
+ 3. gcmO is read with new_GCMRegridder_Mapped(), using bundle_fname
+    as the mapped file: its grids are mapped rather than parsed.  The
+    bundle file is (re)built whenever it is missing or was made from
+    a different gcmO_fname (name, size, mtime).  If bundle_fname is
+    empty, gcmO is read the usual way.
+
+@param global_ecO_fname Output of global_ec (ocean grid); contains EvO.M
+@param gcmO_fname GCMRegridder file (ocean grid), regridder named "m"
+@param bundle_fname Bundle (mapped array) file to use/create; "" for none.
+@return The (shared, read-only) bundle. */
+extern std::shared_ptr<RegridderBundle const> load_regridder_bundle(
+    std::string const &global_ecO_fname,
+    std::string const &gcmO_fname,
+    std::string const &bundle_fname = "");
+
+}}    // namespace
+#endif    // guard
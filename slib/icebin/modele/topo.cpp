@@ -196,9 +196,9 @@ ibmisc::Indexing const indexingHCO,    // gcmA->gcmO->indexingHC
 ibmisc::Indexing const indexingHCA)    // gcmA->indexingHC
 {
     // Call Hntr to generate AOvAA; and use that (above) to produce EOvEA
-    Hntr hntr_AOvAA(17.17, hntrO, hntrA, 0);    // dimB=A,  dimA=O
+    auto hntr_AOvAA(hntr_plan(17.17, hntrO, hntrA, 0));    // dimB=A,  dimA=O
 
-    hntr_AOvAA.overlap<RawEOvEA, DimClip>(
+    hntr_AOvAA->overlap<RawEOvEA, DimClip>(
         RawEOvEA(std::move(ret), wEO_d, nhc, indexingHCO, indexingHCA),
         eq_rad, DimClip(dimAO));
 }
@@ -283,10 +283,10 @@ std::unique_ptr<linear::Weighted_Eigen> _compute_AAmvEAm_EIGEN(
     if (!hntrA.is_set()) (*icebin_error)(-1, "hntrA must be set");
     if (!hntrO.is_set()) (*icebin_error)(-1, "hntrO must be set");
 
-    Hntr hntr_AOmvAAm(17.17, hntrO, hntrA);
+    auto hntr_AOmvAAm(hntr_plan(17.17, hntrO, hntrA));
     EigenSparseMatrixT AAmvAOm(MakeDenseEigenT(
         std::bind(&Hntr::overlap<MakeDenseEigenT::AccumT,DimClip>,
-            &hntr_AOmvAAm, _1, eq_rad, DimClip(&dimAOm)),
+            hntr_AOmvAAm.get(), _1, eq_rad, DimClip(&dimAOm)),
         {SparsifyTransform::TO_DENSE_IGNORE_MISSING, SparsifyTransform::ADD_DENSE},
         {&dimAOm, &dimAAm}, 'T').to_eigen());
 
@@ -618,16 +618,16 @@ blitz::Array<double,3> &elevE3,
 blitz::Array<int16_t,3> &underice3)
 {
 
-    Hntr hntr_AvO(17.17, hspecA, hspecO);
+    auto hntr_AvO(hntr_plan(17.17, hspecA, hspecO));
 
     blitz::Array<double, 2> WTO(const_array(blitz::shape(hspecO.jm,hspecO.im), 1.0));
-    hntr_AvO.regrid(WTO, foceanOm2, foceanA2);
-    hntr_AvO.regrid(WTO, flakeOm2, flakeA2);
-    hntr_AvO.regrid(WTO, fgrndOm2, fgrndA2);
-    hntr_AvO.regrid(WTO, fgiceOm2, fgiceA2);
-    hntr_AvO.regrid(WTO, zatmoOm2, zatmoA2);
-    hntr_AvO.regrid(WTO, zlakeOm2, zlakeA2);
-    hntr_AvO.regrid(fgiceOm2, zicetopOm2, zicetopA2);
+    hntr_AvO->regrid(WTO, foceanOm2, foceanA2);
+    hntr_AvO->regrid(WTO, flakeOm2, flakeA2);
+    hntr_AvO->regrid(WTO, fgrndOm2, fgrndA2);
+    hntr_AvO->regrid(WTO, fgiceOm2, fgiceA2);
+    hntr_AvO->regrid(WTO, zatmoOm2, zatmoA2);
+    hntr_AvO->regrid(WTO, zlakeOm2, zlakeA2);
+    hntr_AvO->regrid(fgiceOm2, zicetopOm2, zicetopA2);
 
     // -------------------------
     // Regrid mergemask (mask, not a double)
@@ -646,7 +646,7 @@ blitz::Array<int16_t,3> &underice3)
         rmm.mergemaskO.reference(reshape1(mergemaskOm2));
         rmm.mergemaskA.reference(reshape1(mergemaskA2));
 
-        hntr_AvO.scaled_regrid_matrix(accum::ref(rmm));
+        hntr_AvO->scaled_regrid_matrix(accum::ref(rmm));
     }
     for (int j=0; j<hspecA.jm; ++j) {
     for (int i=0; i<hspecA.im; ++i) {
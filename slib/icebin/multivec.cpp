@@ -12,6 +12,48 @@ void VectorMultivec::add(long ix, double const *val, double weight)
     for (int i=0; i<nvar; ++i) vals.push_back(val[i]);
 }
 
+void encode_index_deltas(std::vector<long> const &index, std::vector<unsigned char> &out)
+{
+    out.clear();
+    out.reserve(index.size() * 2);
+    long last = 0;
+    for (long const ix : index) {
+        long const delta = ix - last;
+        last = ix;
+
+        // Zigzag: small negative deltas (unsorted input) stay small
+        unsigned long z = ((unsigned long)delta << 1) ^ (unsigned long)(delta >> (8*sizeof(long) - 1));
+        while (z >= 0x80) {
+            out.push_back((unsigned char)(z | 0x80));
+            z >>= 7;
+        }
+        out.push_back((unsigned char)z);
+    }
+}
+
+void decode_index_deltas(std::vector<unsigned char> const &in, size_t n, std::vector<long> &index)
+{
+    index.clear();
+    index.reserve(n);
+    long last = 0;
+    size_t pos = 0;
+    for (size_t i=0; i<n; ++i) {
+        unsigned long z = 0;
+        int shift = 0;
+        for (;;) {
+            if (pos >= in.size()) (*icebin_error)(-1,
+                "Truncated index stream: %ld of %ld elements decoded", (long)i, (long)n);
+            unsigned char const b = in[pos++];
+            z |= (unsigned long)(b & 0x7f) << shift;
+            if (!(b & 0x80)) break;
+            shift += 7;
+        }
+        long const delta = (long)(z >> 1) ^ -(long)(z & 1);
+        last += delta;
+        index.push_back(last);
+    }
+}
+
 VectorMultivec concatenate(std::vector<VectorMultivec> const &vecs)
 {
     VectorMultivec ret(vecs[0].size());
@@ -1,8 +1,10 @@
 #ifndef ICEBIN_MULTIVEC_HPP
 #define ICEBIN_MULTIVEC_HPP
 
+#include <algorithm>
 #include <cstddef>
 #include <vector>
+#include <boost/serialization/split_member.hpp>
 #include <ibmisc/blitz.hpp>
 
 namespace boost {
@@ -12,6 +14,13 @@ namespace serialization {
 
 namespace icebin {
 
+/** Appends successive differences of index to out as zigzag varints
+(LEB128).  Sorted indices take 1-2 bytes each instead of 8. */
+void encode_index_deltas(std::vector<long> const &index, std::vector<unsigned char> &out);
+
+/** Inverse of encode_index_deltas() */
+void decode_index_deltas(std::vector<unsigned char> const &in, size_t n, std::vector<long> &index);
+
 /** Stores multiple sparse vectors that use the same grid cells. */
 class VectorMultivec {
     friend class boost::serialization::access;
@@ -29,6 +38,8 @@ public:
     std::vector<double> vals;
     // Number of _vals element per _ix element
     int nvar;
+    // Send vals in single precision when serialized (MPI scatter)
+    bool wire_float = false;
 
     // Needed by boost::mpi::gather() [GCMCoupler_ModelE.cpp]
     VectorMultivec() :  nvar(-1) {}
@@ -38,14 +49,68 @@ public:
     /** Number of elements in each parallel array. */
     inline size_t size() const { return index.size(); }
 
+    /** Compact wire format: index is delta-encoded as varints (a
+    few bytes per element when sorted); weights collapse to one value
+    when all are equal; vals are optionally narrowed to float. */
     template<typename ArchiveT>
-    void serialize(ArchiveT& ar, const unsigned version) {
-        ar & index;
-        ar & weights;
-        ar & vals;
+    void save(ArchiveT& ar, const unsigned version) const {
         ar & nvar;
+        size_t n = index.size();
+        ar & n;
+        std::vector<unsigned char> index_z;
+        encode_index_deltas(index, index_z);
+        ar & index_z;
+
+        bool const const_weights = std::all_of(weights.begin(), weights.end(),
+            [this](double w) { return w == weights[0]; });
+        ar & const_weights;
+        if (const_weights) {
+            double const w0 = (n == 0 ? 0. : weights[0]);
+            ar & w0;
+        } else {
+            ar & weights;
+        }
+
+        ar & wire_float;
+        if (wire_float) {
+            std::vector<float> vals_f(vals.begin(), vals.end());
+            ar & vals_f;
+        } else {
+            ar & vals;
+        }
     }
 
+    template<typename ArchiveT>
+    void load(ArchiveT& ar, const unsigned version) {
+        ar & nvar;
+        size_t n;
+        ar & n;
+        std::vector<unsigned char> index_z;
+        ar & index_z;
+        decode_index_deltas(index_z, n, index);
+
+        bool const_weights;
+        ar & const_weights;
+        if (const_weights) {
+            double w0;
+            ar & w0;
+            weights.assign(n, w0);
+        } else {
+            ar & weights;
+        }
+
+        ar & wire_float;
+        if (wire_float) {
+            std::vector<float> vals_f;
+            ar & vals_f;
+            vals.assign(vals_f.begin(), vals_f.end());
+        } else {
+            ar & vals;
+        }
+    }
+
+    BOOST_SERIALIZATION_SPLIT_MEMBER()
+
     /** Adds a new element to all the sparse vectors */
     void add(long ix, double const *val, double weight);
 
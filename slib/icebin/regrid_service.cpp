@@ -0,0 +1,431 @@
+#include <algorithm>
+#include <cstdio>
+#include <cerrno>
+#include <cstring>
+#include <limits>
+#include <vector>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <icebin/error.hpp>
+#include <icebin/regrid_service.hpp>
+
+using namespace ibmisc;
+
+namespace icebin {
+namespace regrid_service {
+
+static double const NaN = std::numeric_limits<double>::quiet_NaN();
+
+// ---------------------------------------------------------------
+ShmSegment::ShmSegment(std::string const &name, size_t size, bool create)
+    : _name(name), _size(size), _data(nullptr)
+{
+    int const fd = shm_open(name.c_str(), create ? (O_RDWR|O_CREAT|O_EXCL) : O_RDWR, 0600);
+    if (fd < 0) (*icebin_error)(-1,
+        "Cannot open shared memory %s: %s", name.c_str(), strerror(errno));
+
+    if (create && ftruncate(fd, std::max(size, (size_t)1)) != 0) {
+        close(fd);
+        shm_unlink(name.c_str());
+        (*icebin_error)(-1,
+            "Cannot size shared memory %s to %ld bytes: %s", name.c_str(), (long)size, strerror(errno));
+    }
+
+    // An existing segment must hold everything we are about to read
+    if (!create) {
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            close(fd);
+            (*icebin_error)(-1,
+                "Cannot stat shared memory %s: %s", name.c_str(), strerror(errno));
+        }
+        if ((size_t)st.st_size < size) {
+            close(fd);
+            (*icebin_error)(-1,
+                "Shared memory %s has %ld bytes; expected %ld",
+                name.c_str(), (long)st.st_size, (long)size);
+        }
+    }
+
+    _data = mmap(nullptr, std::max(size, (size_t)1), PROT_READ|PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (_data == MAP_FAILED) (*icebin_error)(-1,
+        "Cannot map shared memory %s: %s", name.c_str(), strerror(errno));
+}
+
+ShmSegment::~ShmSegment()
+{
+    if (_data && _data != MAP_FAILED) munmap(_data, std::max(_size, (size_t)1));
+}
+
+void ShmSegment::unlink()
+    { shm_unlink(_name.c_str()); }
+
+// ---------------------------------------------------------------
+/** Reads or writes exactly n bytes.
+@return false on EOF or error */
+static bool read_full(int fd, void *buf, size_t n)
+{
+    char *p = (char *)buf;
+    while (n > 0) {
+        ssize_t const r = ::read(fd, p, n);
+        if (r < 0 && errno == EINTR) continue;
+        if (r <= 0) return false;
+        p += r;
+        n -= r;
+    }
+    return true;
+}
+
+/** Sockets only.  A peer that has gone away gives EPIPE, not SIGPIPE. */
+static bool write_full(int fd, void const *buf, size_t n)
+{
+    char const *p = (char const *)buf;
+    while (n > 0) {
+        ssize_t const r = ::send(fd, p, n, MSG_NOSIGNAL);
+        if (r < 0 && errno == EINTR) continue;
+        if (r <= 0) return false;
+        p += r;
+        n -= r;
+    }
+    return true;
+}
+
+static sockaddr_un socket_addr(std::string const &socket_path)
+{
+    sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (socket_path.size() >= sizeof(addr.sun_path)) (*icebin_error)(-1,
+        "Socket path too long: %s", socket_path.c_str());
+    strncpy(addr.sun_path, socket_path.c_str(), sizeof(addr.sun_path)-1);
+    return addr;
+}
+
+/** FNV-1a hash of an elevmask, used to key the matrix cache. */
+static uint64_t hash_elevmask(double const *data, long n)
+{
+    uint64_t h = 14695981039346656037ull;
+    unsigned char const *p = (unsigned char const *)data;
+    for (size_t i=0; i<n*sizeof(double); ++i) {
+        h ^= p[i];
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+// ---------------------------------------------------------------
+RegridServer::Matrix const &RegridServer::matrix(
+    Request const &req, blitz::Array<double,1> const &elevmaskI)
+{
+    std::string const sheet(req.sheet);
+    std::string const spec_name(req.matrix);
+
+    EntryKey const key(sheet, hash_elevmask(elevmaskI.data(), elevmaskI.extent(0)),
+        req.scale != 0, req.correctA != 0, req.sigma[0], req.sigma[1], req.sigma[2]);
+
+    // The key holds only a hash of elevmaskI; make sure it is the same
+    auto ii(cache.find(key));
+    if (ii != cache.end()) {
+        auto const &cached(ii->second.elevmaskI);
+        if (cached.extent(0) != elevmaskI.extent(0) ||
+            memcmp(cached.data(), elevmaskI.data(), sizeof(double) * elevmaskI.extent(0)) != 0)
+        {
+            cache.erase(ii);
+            ii = cache.end();
+        }
+    }
+
+    if (ii == cache.end()) {
+        // Make room: drop the least recently used entry
+        if (cache.size() >= max_entries) {
+            auto oldest(cache.begin());
+            for (auto jj=cache.begin(); jj != cache.end(); ++jj) {
+                if (jj->second.last_used < oldest->second.last_used) oldest = jj;
+            }
+            cache.erase(oldest);
+        }
+
+        int const sheet_index = gcm->ice_regridders().index.at(sheet);
+        Entry entry;
+        entry.elevmaskI.reference(blitz::Array<double,1>(elevmaskI.copy()));
+        entry.rm = gcm->regrid_matrices(sheet_index, entry.elevmaskI,
+            RegridParams(req.scale != 0, req.correctA != 0,
+                {req.sigma[0], req.sigma[1], req.sigma[2]}));
+        ii = cache.insert(std::make_pair(key, std::move(entry))).first;
+    }
+
+    Entry &entry(ii->second);
+    entry.last_used = nrequest;
+
+    auto jj(entry.matrices.find(spec_name));
+    if (jj != entry.matrices.end()) return *jj->second;
+
+    printf("regrid_server: Generating %s for %s\n", spec_name.c_str(), sheet.c_str());
+    std::unique_ptr<Matrix> mat(new Matrix);
+    mat->M = entry.rm->matrix_d(spec_name, {&mat->dimB, &mat->dimA}, entry.rm->params());
+    Matrix const &ret(*mat);
+    entry.matrices.insert(std::make_pair(spec_name, std::move(mat)));
+    return ret;
+}
+
+void RegridServer::regrid(Request const &req, Reply &reply)
+{
+    long const nt = req.nt;
+    long const nI = req.nI;
+    long const nA = req.nA;
+
+    // Check the request before touching shared memory
+    int const sheet_index = gcm->ice_regridders().index.at(std::string(req.sheet));
+    long const nI_sheet = gcm->nI(sheet_index);
+    if (nI != nI_sheet) (*icebin_error)(-1,
+        "elevmaskI has %ld grid cells; sheet %s has %ld",
+        nI, req.sheet, nI_sheet);
+    long const max_doubles = std::numeric_limits<long>::max() / sizeof(double);
+    if (nt < 0 || nA < 0 || (nA > 0 && nt > (max_doubles - nI) / nA))
+        (*icebin_error)(-1, "Bad array size: nt=%ld nA=%ld", nt, nA);
+
+    ShmSegment shm_in(req.shm_name, sizeof(double) * (nI + nt*nA), false);
+    blitz::Array<double,1> elevmaskI(shm_in.data(), blitz::shape(nI), blitz::neverDeleteData);
+    blitz::Array<double,2> valA_s(shm_in.data() + nI, blitz::shape(nt, nA), blitz::neverDeleteData);
+
+    Matrix const &mat(matrix(req, elevmaskI));
+    auto const &dimA(mat.dimA);
+    auto const &dimB(mat.dimB);
+    if (nA != dimA.sparse_extent()) (*icebin_error)(-1,
+        "Input has %ld grid cells; matrix %s needs %ld",
+        nA, req.matrix, (long)dimA.sparse_extent());
+    long const nB = dimB.sparse_extent();
+
+    // sparse input --> dense --> M --> sparse output
+    blitz::Array<double,2> valA_d(nt, dimA.dense_extent());
+    for (long it=0; it<nt; ++it) {
+        for (int iA_d=0; iA_d<dimA.dense_extent(); ++iA_d) {
+            valA_d(it, iA_d) = valA_s(it, dimA.to_sparse(iA_d));
+        }
+    }
+
+    TmpAlloc tmp;
+    auto valB_d(mat.M->apply(valA_d, NaN, false, tmp));
+
+    std::string const out_name(std::string(req.shm_name) + "-B");
+    ShmSegment shm_out(out_name, sizeof(double) * nt*nB, true);
+    blitz::Array<double,2> valB_s(shm_out.data(), blitz::shape(nt, nB), blitz::neverDeleteData);
+    valB_s = NaN;
+    for (long it=0; it<nt; ++it) {
+        for (int iB_d=0; iB_d<dimB.dense_extent(); ++iB_d) {
+            valB_s(it, dimB.to_sparse(iB_d)) = valB_d(it, iB_d);
+        }
+    }
+
+    strncpy(reply.shm_name, out_name.c_str(), sizeof(reply.shm_name)-1);
+    reply.nB = nB;
+}
+
+Reply RegridServer::handle(Request &req, bool &done)
+{
+    ++nrequest;
+    Reply reply;
+    memset(&reply, 0, sizeof(reply));
+
+    if (req.magic != MAGIC) {
+        reply.status = -1;
+        strncpy(reply.msg, "Bad request (wrong magic number)", sizeof(reply.msg)-1);
+        return reply;
+    }
+
+    switch((Op)req.op) {
+        case Op::REGRID :
+            req.sheet[sizeof(req.sheet)-1] = '\0';
+            req.matrix[sizeof(req.matrix)-1] = '\0';
+            req.shm_name[sizeof(req.shm_name)-1] = '\0';
+            try {
+                regrid(req, reply);
+            } catch(std::exception const &exp) {
+                reply.status = -1;
+                strncpy(reply.msg, exp.what(), sizeof(reply.msg)-1);
+            }
+        break;
+        case Op::PING :
+        break;
+        case Op::SHUTDOWN :
+            done = true;
+        break;
+        default :
+            reply.status = -1;
+            snprintf(reply.msg, sizeof(reply.msg), "Unknown op %d", req.op);
+    }
+    return reply;
+}
+
+void RegridServer::serve(std::string const &socket_path)
+{
+    int const sfd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (sfd < 0) (*icebin_error)(-1, "Cannot create socket: %s", strerror(errno));
+
+    sockaddr_un const addr(socket_addr(socket_path));
+    ::unlink(socket_path.c_str());
+    if (bind(sfd, (sockaddr const *)&addr, sizeof(addr)) != 0) (*icebin_error)(-1,
+        "Cannot bind %s: %s", socket_path.c_str(), strerror(errno));
+    if (listen(sfd, 8) != 0) (*icebin_error)(-1,
+        "Cannot listen on %s: %s", socket_path.c_str(), strerror(errno));
+    printf("regrid_server: listening on %s\n", socket_path.c_str());
+
+    // Any number of clients stay connected at once.  Requests are
+    // read as their bytes arrive, so an idle or slow client does not
+    // hold up the others; each complete request is answered in turn.
+    struct Connection {
+        int fd;
+        Request req;
+        size_t nread;    // Bytes of req received so far
+    };
+    std::vector<Connection> conns;
+    std::vector<pollfd> pfds;
+
+    bool done = false;
+    while (!done) {
+        pfds.clear();
+        pfds.push_back(pollfd{sfd, POLLIN, 0});
+        for (auto const &conn : conns) pfds.push_back(pollfd{conn.fd, POLLIN, 0});
+
+        if (poll(&pfds[0], pfds.size(), -1) < 0) {
+            if (errno == EINTR) continue;
+            (*icebin_error)(-1, "poll() failed: %s", strerror(errno));
+        }
+
+        // Serve the connections polled, then drop the closed ones
+        for (size_t i=0; i<conns.size() && !done; ++i) {
+            Connection &conn(conns[i]);
+            if (!pfds[i+1].revents) continue;
+
+            ssize_t const r = ::read(conn.fd,
+                (char *)&conn.req + conn.nread, sizeof(conn.req) - conn.nread);
+            if (r < 0 && errno == EINTR) continue;
+            bool keep = (r > 0);
+            if (keep) {
+                conn.nread += r;
+                if (conn.nread == sizeof(conn.req)) {
+                    conn.nread = 0;
+                    Reply const reply(handle(conn.req, done));
+                    keep = write_full(conn.fd, &reply, sizeof(reply));
+                }
+            }
+            if (!keep) {
+                close(conn.fd);
+                conn.fd = -1;
+            }
+        }
+        conns.erase(std::remove_if(conns.begin(), conns.end(),
+            [](Connection const &conn) { return conn.fd < 0; }), conns.end());
+
+        if (!done && (pfds[0].revents & POLLIN)) {
+            int const cfd = accept(sfd, nullptr, nullptr);
+            if (cfd >= 0) {
+                conns.push_back(Connection{cfd, Request(), 0});
+            } else if (errno != EINTR && errno != ECONNABORTED) {
+                (*icebin_error)(-1, "accept() failed: %s", strerror(errno));
+            }
+        }
+    }
+
+    for (auto const &conn : conns) close(conn.fd);
+    close(sfd);
+    ::unlink(socket_path.c_str());
+}
+
+// ---------------------------------------------------------------
+RegridClient::RegridClient(std::string const &socket_path)
+{
+    fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) (*icebin_error)(-1, "Cannot create socket: %s", strerror(errno));
+
+    sockaddr_un const addr(socket_addr(socket_path));
+    if (connect(fd, (sockaddr const *)&addr, sizeof(addr)) != 0) {
+        close(fd);
+        (*icebin_error)(-1,
+            "Cannot connect to regrid_server at %s: %s", socket_path.c_str(), strerror(errno));
+    }
+}
+
+RegridClient::~RegridClient()
+    { close(fd); }
+
+void RegridClient::transact(Request const &req, Reply &reply)
+{
+    if (!write_full(fd, &req, sizeof(req)) || !read_full(fd, &reply, sizeof(reply)))
+        (*icebin_error)(-1, "Lost connection to regrid_server");
+    if (reply.status != 0) {
+        reply.msg[sizeof(reply.msg)-1] = '\0';
+        (*icebin_error)(-1, "regrid_server: %s", reply.msg);
+    }
+}
+
+static Request new_request(Op op)
+{
+    Request req;
+    memset(&req, 0, sizeof(req));
+    req.magic = MAGIC;
+    req.op = (int32_t)op;
+    return req;
+}
+
+blitz::Array<double,2> RegridClient::regrid(
+    std::string const &sheet,
+    std::string const &matrix,
+    blitz::Array<double,1> const &elevmaskI,
+    RegridParams const &params,
+    blitz::Array<double,2> const &valA)
+{
+    Request req(new_request(Op::REGRID));
+    if (sheet.size() >= sizeof(req.sheet) || matrix.size() >= sizeof(req.matrix))
+        (*icebin_error)(-1, "Sheet or matrix name too long: %s %s", sheet.c_str(), matrix.c_str());
+    strncpy(req.sheet, sheet.c_str(), sizeof(req.sheet)-1);
+    strncpy(req.matrix, matrix.c_str(), sizeof(req.matrix)-1);
+    req.scale = params.scale;
+    req.correctA = params.correctA;
+    for (int i=0; i<3; ++i) req.sigma[i] = params.sigma[i];
+    req.nI = elevmaskI.extent(0);
+    req.nt = valA.extent(0);
+    req.nA = valA.extent(1);
+
+    // Put the input arrays in shared memory
+    snprintf(req.shm_name, sizeof(req.shm_name), "/icebin-%d-%ld", (int)getpid(), nrequest++);
+    ShmSegment shm_in(req.shm_name, sizeof(double) * (req.nI + req.nt*req.nA), true);
+    blitz::Array<double,1>(shm_in.data(), blitz::shape(req.nI), blitz::neverDeleteData) = elevmaskI;
+    blitz::Array<double,2>(shm_in.data() + req.nI, blitz::shape(req.nt, req.nA), blitz::neverDeleteData) = valA;
+
+    Reply reply;
+    try {
+        transact(req, reply);
+    } catch(...) {
+        shm_in.unlink();
+        throw;
+    }
+    shm_in.unlink();
+
+    // Copy the output out of shared memory
+    ShmSegment shm_out(reply.shm_name, sizeof(double) * req.nt*reply.nB, false);
+    shm_out.unlink();
+    blitz::Array<double,2> valB(req.nt, reply.nB);
+    valB = blitz::Array<double,2>(shm_out.data(), blitz::shape(req.nt, reply.nB), blitz::neverDeleteData);
+    return valB;
+}
+
+void RegridClient::ping()
+{
+    Reply reply;
+    transact(new_request(Op::PING), reply);
+}
+
+void RegridClient::shutdown_server()
+{
+    Reply reply;
+    transact(new_request(Op::SHUTDOWN), reply);
+}
+
+}}    // namespace
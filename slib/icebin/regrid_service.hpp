@@ -0,0 +1,155 @@
+#ifndef ICEBIN_REGRID_SERVICE_HPP
+#define ICEBIN_REGRID_SERVICE_HPP
+
+#include <map>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <cstdint>
+#include <blitz/array.h>
+#include <ibmisc/linear/eigen.hpp>
+#include <icebin/GCMRegridder.hpp>
+#include <icebin/RegridMatrices_Dynamic.hpp>
+
+/** A long-lived local process (regrid_server) that loads a
+GCMRegridder once, and regrids arrays for clients on the same machine.
+Regrid matrices are built the first time they are asked for, and kept
+for later requests with the same (sheet, elevmask, params).
+
+Requests and replies are fixed-size structs sent over a Unix domain
+socket.  Arrays travel through POSIX shared memory: the client puts
+elevmaskI and the input values in a segment it creates; the server
+writes the output values in a segment it creates, which the client
+unlinks after reading. */
+
+namespace icebin {
+namespace regrid_service {
+
+uint32_t const MAGIC = 0x49424e52;    // "IBNR"
+
+enum class Op : int32_t { REGRID = 1, PING = 2, SHUTDOWN = 3 };
+
+struct Request {
+    uint32_t magic;
+    int32_t op;             // Op
+    char sheet[64];         // Ice sheet name
+    char matrix[8];         // Regrid matrix (eg: "IvE")
+
+    // RegridParams
+    int32_t scale;
+    int32_t correctA;
+    double sigma[3];
+
+    // Shared memory segment holding elevmaskI[nI], then valA[nt,nA]
+    char shm_name[64];
+    int64_t nI;
+    int64_t nt;
+    int64_t nA;             // Sparse extent of the matrix's input grid
+};
+
+struct Reply {
+    int32_t status;         // 0 = OK
+    char msg[256];          // Error message, if status != 0
+
+    // Shared memory segment holding valB[nt,nB]; client must unlink it
+    char shm_name[64];
+    int64_t nB;             // Sparse extent of the matrix's output grid
+};
+
+// ---------------------------------------------------------------
+/** A POSIX shared memory segment, mapped into this process. */
+class ShmSegment {
+    std::string _name;
+    size_t _size;
+    void *_data;
+public:
+    /** Creates (create=true) or opens an existing segment */
+    ShmSegment(std::string const &name, size_t size, bool create);
+    ~ShmSegment();
+
+    ShmSegment(ShmSegment const &) = delete;
+    ShmSegment &operator=(ShmSegment const &) = delete;
+
+    std::string const &name() const { return _name; }
+    size_t size() const { return _size; }
+    double *data() { return (double *)_data; }
+
+    /** Removes the name; the memory is freed once everyone unmaps it. */
+    void unlink();
+};
+
+// ---------------------------------------------------------------
+/** The service side; see regrid_server. */
+class RegridServer {
+    GCMRegridder const *gcm;
+
+    /** A regrid matrix, along with the dimensions it was built with. */
+    struct Matrix {
+        SparseSetT dimB, dimA;    // Output and input grids
+        std::unique_ptr<ibmisc::linear::Weighted_Eigen> M;
+    };
+
+    /** Matrices for one (sheet, elevmask, params) */
+    struct Entry {
+        blitz::Array<double,1> elevmaskI;    // Our own copy; rm refers to it.  Checked on cache hits.
+        std::unique_ptr<RegridMatrices_Dynamic> rm;
+        std::map<std::string, std::unique_ptr<Matrix>> matrices;
+        long last_used;
+    };
+
+    // (sheet, hash of elevmaskI, scale, correctA, sigma)
+    typedef std::tuple<std::string, uint64_t, bool, bool, double, double, double> EntryKey;
+    std::map<EntryKey, Entry> cache;
+    size_t max_entries;
+    long nrequest = 0;
+
+    Matrix const &matrix(Request const &req, blitz::Array<double,1> const &elevmaskI);
+    void regrid(Request const &req, Reply &reply);
+
+    /** Answers one request.
+    @param done Set if the request asks the server to exit */
+    Reply handle(Request &req, bool &done);
+
+public:
+    /** @param _max_entries Most (sheet, elevmask, params) combinations
+        to keep matrices for; least recently used are dropped. */
+    RegridServer(GCMRegridder const *_gcm, size_t _max_entries = 16)
+        : gcm(_gcm), max_entries(_max_entries) {}
+
+    /** Listens on socket_path until a client sends Op::SHUTDOWN.
+    Several clients may be connected at once. */
+    void serve(std::string const &socket_path);
+};
+
+// ---------------------------------------------------------------
+/** Client for a running regrid_server. */
+class RegridClient {
+    int fd;
+    long nrequest = 0;
+
+    void transact(Request const &req, Reply &reply);
+public:
+    RegridClient(std::string const &socket_path);
+    ~RegridClient();
+
+    /** Regrids nt arrays at once.
+    @param matrix Name of regrid matrix (eg: "IvE")
+    @param elevmaskI Elevation mask for the ice sheet (NaN where masked out)
+    @param valA (nt, nA) Input values, sparse indexing
+    @return (nt, nB) Output values, sparse indexing; NaN where not regridded */
+    blitz::Array<double,2> regrid(
+        std::string const &sheet,
+        std::string const &matrix,
+        blitz::Array<double,1> const &elevmaskI,
+        RegridParams const &params,
+        blitz::Array<double,2> const &valA);
+
+    /** Checks the server is alive. */
+    void ping();
+
+    /** Asks the server to exit. */
+    void shutdown_server();
+};
+
+}}    // namespace
+#endif    // guard
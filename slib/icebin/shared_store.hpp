@@ -0,0 +1,46 @@
+#ifndef ICEBIN_SHARED_STORE_HPP
+#define ICEBIN_SHARED_STORE_HPP
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <functional>
+
+namespace icebin {
+
+/** Process-wide store of immutable objects (regridders, base
+matrices), keyed on where they were loaded from.  Used when several
+ensemble members run in one process (GCMParams::share_regridders):
+the first member to ask loads the object, later members get the same
+copy.  Entries are held weakly, so an object is freed once the last
+member using it is done. */
+template<class KeyT, class ValT>
+class SharedStore {
+    std::mutex mutex;
+    std::map<KeyT, std::weak_ptr<ValT>> entries;
+
+public:
+    /** @param load Creates the object, if it is not already in the store.
+    @return The (shared) object.  Callers must not modify it. */
+    std::shared_ptr<ValT> get(
+        KeyT const &key,
+        std::function<std::shared_ptr<ValT>()> const &load)
+    {
+        // Hold the lock while loading, so members starting at the
+        // same time do not load the same thing twice.
+        std::lock_guard<std::mutex> lock(mutex);
+
+        auto ii(entries.find(key));
+        if (ii != entries.end()) {
+            std::shared_ptr<ValT> val(ii->second.lock());
+            if (val) return val;
+        }
+
+        std::shared_ptr<ValT> val(load());
+        entries[key] = val;
+        return val;
+    }
+};
+
+}    // namespace icebin
+#endif    // guard
@@ -3,6 +3,9 @@
 
 // TODO: Expand and put in ibmisc/linear.  See tuplelist.hpp
 
+#include <array>
+#include <vector>
+
 namespace icebin {
 
 /** Vector-based sparse matrix with sparse indexing */
@@ -54,5 +57,33 @@ public:
 
 };
 
+/** Sparse matrix stored column-wise (structure of arrays), in the
+layout Fortran sees as indices(nnz,NCOL): all of index column 0,
+then all of index column 1, etc.  Storage is reused between
+resize() calls, so refilling with a similar nnz does not allocate. */
+template<class IndexT, class ValT, int NCOL>
+class VectorSparseSoA {
+public:
+    typedef IndexT index_type;
+    typedef ValT val_type;
+    static const int ncol = NCOL;
+
+    std::vector<IndexT> indices;    // [NCOL * nnz]
+    std::vector<ValT> values;       // [nnz]
+
+    size_t size() const { return values.size(); }
+
+    /** Sizes for nnz elements; contents are left undefined. */
+    void resize(size_t nnz)
+    {
+        indices.resize(NCOL * nnz);
+        values.resize(nnz);
+    }
+
+    /** @return Start of index column k (0-based) */
+    IndexT *col(int k)
+        { return indices.data() + k * values.size(); }
+};
+
 } // namespace icebin
 #endif
@@ -0,0 +1,163 @@
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <zlib.h>
+#include <icebin/zeigen.hpp>
+#include <icebin/error.hpp>
+
+namespace icebin {
+
+// ---------------------------------------------------------
+static void put_varint(std::vector<uint8_t> &buf, uint64_t v)
+{
+    while (v >= 0x80) {
+        buf.push_back((uint8_t)(v | 0x80));
+        v >>= 7;
+    }
+    buf.push_back((uint8_t)v);
+}
+
+static uint64_t get_varint(uint8_t const *&p, uint8_t const *end)
+{
+    uint64_t v = 0;
+    for (int shift=0; ; shift += 7) {
+        if (p == end || shift > 63) (*icebin_error)(-1,
+            "ZEigenSparse: corrupt index stream");
+        uint8_t const b = *p++;
+        v |= (uint64_t)(b & 0x7f) << shift;
+        if (!(b & 0x80)) return v;
+    }
+}
+
+/** Deflates raw into a string, prefixed by the raw length */
+static std::string deflate(std::vector<uint8_t> const &raw)
+{
+    uint64_t const nraw = raw.size();
+    uLongf nz = compressBound(nraw);
+    std::string ret(sizeof(nraw) + nz, '\0');
+    memcpy(&ret[0], &nraw, sizeof(nraw));
+    int const err = compress2(
+        (Bytef *)&ret[sizeof(nraw)], &nz, raw.data(), nraw, Z_BEST_SPEED);
+    if (err != Z_OK) (*icebin_error)(-1,
+        "ZEigenSparse: compress2() failed (%d)", err);
+    ret.resize(sizeof(nraw) + nz);
+    return ret;
+}
+
+static std::vector<uint8_t> inflate(std::string const &z)
+{
+    uint64_t nraw;
+    memcpy(&nraw, z.data(), sizeof(nraw));
+    std::vector<uint8_t> raw(nraw);
+    uLongf n = nraw;
+    int const err = uncompress(raw.data(), &n,
+        (Bytef const *)z.data() + sizeof(nraw), z.size() - sizeof(nraw));
+    if (err != Z_OK || n != nraw) (*icebin_error)(-1,
+        "ZEigenSparse: uncompress() failed (%d)", err);
+    return raw;
+}
+// ---------------------------------------------------------
+
+ZEigenSparse::ZEigenSparse(EigenSparseMatrixT const &M)
+    : _set(true), _rows(M.rows()), _cols(M.cols()), _nnz(M.nonZeros())
+{
+    std::vector<uint8_t> index;
+    index.reserve(M.outerSize() + 2*_nnz);
+    std::vector<double> values;
+    values.reserve(_nnz);
+
+    // Outer vector lengths first, so the decoder can fill outerIndexPtr
+    for (int k=0; k<M.outerSize(); ++k) {
+        uint64_t n = 0;
+        for (EigenSparseMatrixT::InnerIterator ii(M,k); ii; ++ii) ++n;
+        put_varint(index, n);
+    }
+
+    // Inner indices, delta-encoded within each outer vector
+    for (int k=0; k<M.outerSize(); ++k) {
+        long last = 0;
+        for (EigenSparseMatrixT::InnerIterator ii(M,k); ii; ++ii) {
+            put_varint(index, ii.index() - last);
+            last = ii.index();
+            values.push_back(ii.value());
+        }
+    }
+    zindex = deflate(index);
+
+    // Byte-shuffle the values
+    std::vector<uint8_t> shuffled(_nnz * sizeof(double));
+    uint8_t const *vbytes = (uint8_t const *)values.data();
+    for (long i=0; i<_nnz; ++i) {
+        for (size_t b=0; b<sizeof(double); ++b) {
+            shuffled[b*_nnz + i] = vbytes[i*sizeof(double) + b];
+        }
+    }
+    zvalues = deflate(shuffled);
+}
+
+EigenSparseMatrixT ZEigenSparse::to_eigen() const
+{
+    EigenSparseMatrixT M(_rows, _cols);
+    M.resizeNonZeros(_nnz);
+    if (_nnz == 0) return M;
+
+    auto *outer(M.outerIndexPtr());
+    auto *inner(M.innerIndexPtr());
+    double *val(M.valuePtr());
+
+    std::vector<uint8_t> const index(inflate(zindex));
+    uint8_t const *p = index.data();
+    uint8_t const *const end = p + index.size();
+
+    outer[0] = 0;
+    for (int k=0; k<M.outerSize(); ++k) {
+        outer[k+1] = outer[k] + get_varint(p, end);
+    }
+    if (outer[M.outerSize()] != _nnz) (*icebin_error)(-1,
+        "ZEigenSparse: index stream has %ld non-zeros, expected %ld",
+        (long)outer[M.outerSize()], _nnz);
+
+    for (int k=0; k<M.outerSize(); ++k) {
+        long last = 0;
+        for (auto j=outer[k]; j<outer[k+1]; ++j) {
+            last += get_varint(p, end);
+            inner[j] = last;
+        }
+    }
+
+    std::vector<uint8_t> const shuffled(inflate(zvalues));
+    uint8_t *vbytes = (uint8_t *)val;
+    for (long i=0; i<_nnz; ++i) {
+        for (size_t b=0; b<sizeof(double); ++b) {
+            vbytes[i*sizeof(double) + b] = shuffled[b*_nnz + i];
+        }
+    }
+
+    return M;
+}
+
+void ZEigenSparse::clear()
+{
+    _set = false;
+    _rows = _cols = _nnz = 0;
+    zindex.clear();
+    zindex.shrink_to_fit();
+    zvalues.clear();
+    zvalues.shrink_to_fit();
+}
+// ---------------------------------------------------------
+
+void stash(std::unique_ptr<EigenSparseMatrixT> &M, ZEigenSparse &Z)
+{
+    if (!M) return;
+    Z = ZEigenSparse(*M);
+    M.reset();
+}
+
+void unstash(std::unique_ptr<EigenSparseMatrixT> &M, ZEigenSparse &Z)
+{
+    if (!M && !Z.empty()) M.reset(new EigenSparseMatrixT(Z.to_eigen()));
+    Z.clear();
+}
+
+}    // namespace icebin
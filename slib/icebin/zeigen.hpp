@@ -0,0 +1,54 @@
+#ifndef ICEBIN_ZEIGEN_HPP
+#define ICEBIN_ZEIGEN_HPP
+
+#include <memory>
+#include <string>
+#include <icebin/eigen_types.hpp>
+
+namespace icebin {
+
+/** Losslessly compressed in-memory copy of an EigenSparseMatrixT.
+Used for matrices the coupler keeps between coupling steps, but does
+not need until the next one (IceCoupler::IvE0, GCMCoupler::XuE0s);
+see GCMParams::compress_held_matrices.
+
+Storage (cf. ibmisc::ZArray, which does the same for files):
+  * zindex: number of non-zeros in each outer vector, followed by the
+    delta-encoded inner indices (first absolute, then increments);
+    all as LEB128 varints, then deflated.
+  * zvalues: the values, byte-shuffled (all first bytes, then all
+    second bytes...) so that exponents compress well, then deflated. */
+class ZEigenSparse {
+    bool _set = false;
+    long _rows = 0;
+    long _cols = 0;
+    long _nnz = 0;
+    std::string zindex;
+    std::string zvalues;
+
+public:
+    ZEigenSparse() {}
+    explicit ZEigenSparse(EigenSparseMatrixT const &M);
+
+    /** Decompresses into a new (compressed-storage) Eigen matrix. */
+    EigenSparseMatrixT to_eigen() const;
+
+    long rows() const { return _rows; }
+    long cols() const { return _cols; }
+    long nnz() const { return _nnz; }
+
+    /** Bytes used by the compressed data */
+    size_t nbytes() const { return zindex.size() + zvalues.size(); }
+
+    bool empty() const { return !_set; }
+    void clear();
+};
+
+/** Compresses *M into Z, then frees M.  Does nothing if M is not set. */
+extern void stash(std::unique_ptr<EigenSparseMatrixT> &M, ZEigenSparse &Z);
+
+/** Undoes stash(): restores M from Z (if M was stashed), and clears Z. */
+extern void unstash(std::unique_ptr<EigenSparseMatrixT> &M, ZEigenSparse &Z);
+
+}    // namespace icebin
+#endif    // guard
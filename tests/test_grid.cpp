@@ -19,15 +19,39 @@
 // https://github.com/google/googletest/blob/master/googletest/docs/Primer.md
 
 #include <iostream>
+#include <set>
 #include <cstdio>
+#include <cmath>
+#include <sstream>
+#include <limits>
+#include <memory>
+#include <unistd.h>
+#include <signal.h>
+#include <sys/wait.h>
 #include <netcdf>
+#include <boost/archive/binary_oarchive.hpp>
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/serialization/vector.hpp>
 #include <gtest/gtest.h>
 #include <icebin/Grid.hpp>
 #include <icebin/GridSpec.hpp>
 #include <icebin/gridgen/GridGen_LonLat.hpp>
+#include <icebin/gridgen/GridGen_XY.hpp>
+#include <icebin/gridgen/GridGen_Exchange.hpp>
+#include <icebin/GCMRegridder.hpp>
+#include <icebin/IceRegridder.hpp>
+#include <icebin/RegridMatrices_Dynamic.hpp>
+#include <icebin/multivec.hpp>
+#include <icebin/error.hpp>
+#include <icebin/shared_store.hpp>
+#include <icebin/regrid_service.hpp>
+#include <ibmisc/error.hpp>
 #ifdef BUILD_MODELE
 #include <icebin/modele/clippers.hpp>
 #endif
+#if defined(BUILD_MODELE) && defined(BUILD_COUPLER)
+#include <icebin/modele/GCMCoupler_ModelE.hpp>
+#endif
 
 using namespace std::placeholders;  // for _1, _2, _3...
 using namespace ibmisc;
@@ -224,6 +248,23 @@ TEST_F(GridTest, create_grid)
         expect_eq(grid2, grid);
     }
 
+    // ---------------- Read through a reference (see overlap -r)
+    std::string ref_fname("__netcdf_test_ref.nc");
+    tmpfiles.push_back(ref_fname);
+    ::remove(ref_fname.c_str());
+    {
+        ibmisc::NcIO ncio(ref_fname, NcFile::replace);
+        write_grid_ref(ncio, "gridA", fname, "grid");
+        ncio.close();
+    }
+    {
+        Grid grid3;
+        ibmisc::NcIO ncio(ref_fname, NcFile::read);
+        grid3.ncio(ncio, "gridA");
+        ncio.close();
+
+        expect_eq(grid3, grid);
+    }
 }
 
 TEST_F(GridTest, centroid)
@@ -259,6 +300,107 @@ TEST_F(GridTest, centroid)
     }
 
 }
+TEST_F(GridTest, exchange_xy)
+{
+    // Two XY grids on the same projection, with unaligned boundaries.
+    std::string const sproj("+proj=stere +lat_0=90 +lat_ts=71 +lon_0=-39 +k=1 +x_0=0 +y_0=0 +ellps=WGS84");
+    GridSpec_XY specA(GridSpec_XY::make_with_boundaries(sproj, {0,1},
+        0., 300., 100., 0., 200., 100.));
+    GridSpec_XY specI(GridSpec_XY::make_with_boundaries(sproj, {1,0},
+        50., 350., 30., -20., 160., 30.));
+    Grid gridA(make_grid("A", specA));
+    Grid gridI(make_grid("I", specI));
+
+    Grid exgrid(make_exchange_grid(&gridA, &gridI));
+
+    // Exchange cells must tile the intersection of the two grids
+    // [50,300] x [0,160], and each must lie within its A and I cells.
+    double total = 0;
+    std::vector<double> areaA(gridA.ndata(), 0.);
+    for (auto cell = exgrid.cells.begin(); cell != exgrid.cells.end(); ++cell) {
+        EXPECT_EQ(4, cell->size());
+        EXPECT_GT(cell->native_area, 0.);
+        total += cell->native_area;
+        areaA[cell->i] += cell->native_area;
+
+        Point const c(cell->centroid());
+        Point const cA(gridA.cells.at(cell->i)->centroid());
+        Point const cI(gridI.cells.at(cell->j)->centroid());
+        EXPECT_LT(std::abs(c.x - cA.x), 50.);
+        EXPECT_LT(std::abs(c.y - cA.y), 50.);
+        EXPECT_LT(std::abs(c.x - cI.x), 15.);
+        EXPECT_LT(std::abs(c.y - cI.y), 15.);
+    }
+    EXPECT_DOUBLE_EQ(250. * 160., total);
+    EXPECT_EQ(10 * 6, exgrid.cells.nrealized());
+}
+// ------------------------------------------------------------
+TEST_F(GridTest, hcdefsA)
+{
+    // Two A cells, each covered by 2x2 ice cells
+    std::string const sproj("+proj=stere +lat_0=90 +lat_ts=71 +lon_0=-39 +k=1 +x_0=0 +y_0=0 +ellps=WGS84");
+    GridSpec_XY specA(GridSpec_XY::make_with_boundaries(sproj, {1,0},
+        0., 200., 100., 0., 100., 100.));
+    GridSpec_XY specI(GridSpec_XY::make_with_boundaries(sproj, {1,0},
+        0., 200., 50., 0., 100., 50.));
+    Grid gridA(make_grid("A", specA));
+    Grid gridI(make_grid("I", specI));
+    Grid exgrid(make_exchange_grid(&gridA, &gridI));
+
+    long const nA = gridA.ndata();
+    GCMRegridder_Standard gcm;
+    gcm.init(AbbrGrid(gridA), std::vector<double>{0., 1000.},
+        Indexing({"A", "HC"}, {0,0}, {nA, 3}, {1,0}), false);
+
+    // A cell 0 has one elevation class, A cell 1 has three
+    gcm.set_hcdefsA(std::vector<long>{0, 1, 4},
+        std::vector<double>{500., 0., 1000., 2000.});
+    EXPECT_EQ(1u, gcm.nhc(0));
+    EXPECT_EQ(3u, gcm.nhc(1));
+    EXPECT_EQ(0., gcm.hcdefs(1)[0]);
+
+    auto sheet(new_ice_regridder(gridI.parameterization));
+    sheet->init("sheet", *gcm.agridA, &gridA,
+        AbbrGrid(gridI), ExchangeGrid(exgrid), InterpStyle::Z_INTERP);
+    gcm.add_sheet(std::move(sheet));
+
+    blitz::Array<double,1> elevmaskI(gcm.nI(0));
+    elevmaskI = 800.;    // All ice
+    auto rm(gcm.regrid_matrices(0, elevmaskI, RegridParams(false, true, {0.,0.,0.})));
+
+    // GvEp: 800m falls in cell 1's classes 0 and 1; cell 0's only class
+    SparseSetT dimI, dimE;
+    auto IvE(rm->matrix_d("IvE", {&dimI, &dimE}, RegridParams(true, false, {0.,0.,0.})));
+    std::set<long> expectedE {
+        gcm.indexingHC.tuple_to_index<long,2>({0, 0}),
+        gcm.indexingHC.tuple_to_index<long,2>({1, 0}),
+        gcm.indexingHC.tuple_to_index<long,2>({1, 1})};
+    std::set<long> gotE;
+    for (int id=0; id<dimE.dense_extent(); ++id) gotE.insert(dimE.to_sparse(id));
+    EXPECT_EQ(expectedE, gotE);
+
+    // Scaled IvE: each ice cell is a weighted average of E cells
+    blitz::Array<double,1> rowsum(dimI.dense_extent());
+    rowsum = 0;
+    for (int k=0; k<IvE->M->outerSize(); ++k)
+    for (EigenSparseMatrixT::InnerIterator ii(*IvE->M, k); ii; ++ii)
+        rowsum(ii.row()) += ii.value();
+    for (int i=0; i<rowsum.extent(0); ++i) EXPECT_NEAR(1., rowsum(i), 1e-12);
+
+    // sEpvE (via EvA, correctA=true) generates only E cells in each
+    // A cell's own list: nothing beyond cell 0's single class.
+    SparseSetT dimE2, dimA2;
+    auto EvA(rm->matrix_d("EvA", {&dimE2, &dimA2}, RegridParams(true, true, {0.,0.,0.})));
+    for (int id=0; id<dimE2.dense_extent(); ++id) {
+        auto tuple(gcm.indexingHC.index_to_tuple<long,2>(dimE2.to_sparse(id)));
+        EXPECT_LT(tuple[1], (long)gcm.nhc(tuple[0]));
+    }
+    EXPECT_EQ(2, dimA2.dense_extent());
+
+    // A cell (x=1,y=0) is entirely covered by gridI
+    long const iA = gridA.indexing.tuple_to_index<int,2>({1,0});
+    EXPECT_DOUBLE_EQ(100. * 100., areaA[iA]);
+}
 // ------------------------------------------------------------
 #ifdef BUILD_MODELE
 
@@ -293,6 +435,297 @@ TEST_F(GridTest, hntr)
 }
 #endif // BUILD_MODELE
 // ------------------------------------------------------------
+#if defined(BUILD_MODELE) && defined(BUILD_COUPLER)
+
+TEST_F(GridTest, domain_decomposition)
+{
+    auto const old_error(icebin_error);
+    icebin_error = &throw_error;
+
+    long const im = 4, jm = 2;
+    ibmisc::Domain const domainA_global({0,0}, {im,jm});
+
+    // Two ranks whose arrays overlap in i=1,2 (eg: halos)
+    std::vector<ibmisc::Domain> blocks {
+        ibmisc::Domain({0,0}, {3,jm}),
+        ibmisc::Domain({1,0}, {4,jm})};
+
+    // Non-block owner map: a staircase through the overlap
+    //     j=1:  0 0 1 1
+    //     j=0:  0 1 1 1
+    std::vector<int> rank_of_iA {0,1,1,1, 0,0,1,1};
+    EXPECT_FALSE(blocks_partition(blocks, domainA_global));    // gcmce_new() leaves the map to the GCM
+    check_rank_of_iA(rank_of_iA, blocks, domainA_global);
+
+    // Each rank packs exactly the cells it owns, all within its arrays
+    std::vector<int> npack(im*jm, 0);
+    for (int rank=0; rank<(int)blocks.size(); ++rank) {
+        for (long iA : owned_cells(rank_of_iA, rank)) {
+            long const i = iA % im;
+            long const j = iA / im;
+            EXPECT_TRUE(i >= blocks[rank][0].begin && i < blocks[rank][0].end);
+            EXPECT_TRUE(j >= blocks[rank][1].begin && j < blocks[rank][1].end);
+            ++npack[iA];
+        }
+    }
+    for (int n : npack) EXPECT_EQ(1, n);
+
+    DomainDecomposer_ModelE domains(std::vector<int>(rank_of_iA), blocks.size());
+    long const nA = im*jm;
+    for (long iA=0; iA<nA; ++iA) {
+        EXPECT_EQ(rank_of_iA[iA], domains.get_domain(iA));
+        EXPECT_EQ(rank_of_iA[iA], domains.get_domain(2*nA + iA));    // iE, ihc=2
+    }
+
+    // Same map, but with latitude bands: cell (1,0) is given to rank
+    // 1, which does not hold row j=0.
+    std::vector<ibmisc::Domain> bands {
+        ibmisc::Domain({0,0}, {im,1}),
+        ibmisc::Domain({0,1}, {im,2})};
+    EXPECT_TRUE(blocks_partition(bands, domainA_global));
+    EXPECT_THROW(check_rank_of_iA(rank_of_iA, bands, domainA_global), icebin::Error);
+
+    // Out-of-range rank
+    std::vector<int> bad_rank(rank_of_iA);
+    bad_rank[0] = 2;
+    EXPECT_THROW(check_rank_of_iA(bad_rank, blocks, domainA_global), icebin::Error);
+
+    icebin_error = old_error;
+}
+
+#endif // BUILD_MODELE && BUILD_COUPLER
+// ------------------------------------------------------------
+/** Serializes mv through the wire format and reads it back */
+static VectorMultivec wire_round_trip(VectorMultivec const &mv)
+{
+    std::stringstream ss;
+    {boost::archive::binary_oarchive oa(ss);
+        oa << mv;
+    }
+    VectorMultivec ret;
+    {boost::archive::binary_iarchive ia(ss);
+        ia >> ret;
+    }
+    return ret;
+}
+
+TEST_F(GridTest, multivec_wire)
+{
+    auto const old_error(icebin_error);
+    icebin_error = &throw_error;
+
+    // Index delta codec: sorted, unsorted, negative and large indices
+    std::vector<long> const index {0, 1, 2, 130, 129, 5, -7, 1L<<40, 3};
+    std::vector<unsigned char> bytes;
+    encode_index_deltas(index, bytes);
+    std::vector<long> index2;
+    decode_index_deltas(bytes, index.size(), index2);
+    EXPECT_EQ(index, index2);
+
+    // Small sorted deltas take one byte each
+    std::vector<long> sorted;
+    for (long i=0; i<1000; ++i) sorted.push_back(3*i);
+    encode_index_deltas(sorted, bytes);
+    EXPECT_EQ(sorted.size(), bytes.size());
+    decode_index_deltas(bytes, sorted.size(), index2);
+    EXPECT_EQ(sorted, index2);
+
+    // Asking for more elements than were encoded
+    EXPECT_THROW(decode_index_deltas(bytes, sorted.size()+1, index2), icebin::Error);
+
+    // Full VectorMultivec, with constant and varying weights,
+    // in double and reduced (float) precision
+    for (bool const const_weights : {true, false}) {
+    for (bool const wire_float : {false, true}) {
+        VectorMultivec mv(2);
+        mv.wire_float = wire_float;
+        for (int i=0; i<5; ++i) {
+            double const vals[2] {i + .1, -1e-3 * i / 3.};
+            mv.add(index[i], vals, const_weights ? 2. : i + .5);
+        }
+
+        VectorMultivec const mv2(wire_round_trip(mv));
+        EXPECT_EQ(mv.nvar, mv2.nvar);
+        EXPECT_EQ(mv.index, mv2.index);
+        EXPECT_EQ(mv.weights, mv2.weights);
+        EXPECT_EQ(wire_float, mv2.wire_float);
+        ASSERT_EQ(mv.vals.size(), mv2.vals.size());
+        for (size_t i=0; i<mv.vals.size(); ++i) {
+            EXPECT_EQ(wire_float ? (double)(float)mv.vals[i] : mv.vals[i], mv2.vals[i]);
+        }
+    }}
+
+    // Empty vector
+    VectorMultivec const empty2(wire_round_trip(VectorMultivec(3)));
+    EXPECT_EQ(3, empty2.nvar);
+    EXPECT_EQ(0, empty2.size());
+    EXPECT_EQ(0, empty2.weights.size());
+
+    icebin_error = old_error;
+}
+// ------------------------------------------------------------
+TEST_F(GridTest, shared_store)
+{
+    SharedStore<std::string, int> store;
+    int nload = 0;
+    auto const load = [&nload]() { ++nload; return std::make_shared<int>(nload); };
+
+    // Second member with the same key gets the first member's copy
+    std::shared_ptr<int> a1(store.get("a", load));
+    std::shared_ptr<int> a2(store.get("a", load));
+    EXPECT_EQ(a1.get(), a2.get());
+    EXPECT_EQ(1, nload);
+
+    // Different key, different object
+    std::shared_ptr<int> b1(store.get("b", load));
+    EXPECT_NE(a1.get(), b1.get());
+    EXPECT_EQ(2, nload);
+
+    // Freed once the last member lets go; the next get() reloads
+    a1.reset();
+    a2.reset();
+    std::shared_ptr<int> a3(store.get("a", load));
+    EXPECT_EQ(3, nload);
+    EXPECT_EQ(3, *a3);
+}
+// ------------------------------------------------------------
+TEST_F(GridTest, regrid_service)
+{
+    auto const old_icebin_error(icebin_error);
+    auto const old_ibmisc_error(ibmisc_error);
+    icebin_error = &throw_error;
+    ibmisc_error = &throw_error;
+
+    // Two A cells, each covered by 2x2 ice cells
+    std::string const sproj("+proj=stere +lat_0=90 +lat_ts=71 +lon_0=-39 +k=1 +x_0=0 +y_0=0 +ellps=WGS84");
+    GridSpec_XY specA(GridSpec_XY::make_with_boundaries(sproj, {1,0},
+        0., 200., 100., 0., 100., 100.));
+    GridSpec_XY specI(GridSpec_XY::make_with_boundaries(sproj, {1,0},
+        0., 200., 50., 0., 100., 50.));
+    Grid gridA(make_grid("A", specA));
+    Grid gridI(make_grid("I", specI));
+    Grid exgrid(make_exchange_grid(&gridA, &gridI));
+
+    long const nA = gridA.ndata();
+    GCMRegridder_Standard gcm;
+    gcm.init(AbbrGrid(gridA), std::vector<double>{0., 1000.},
+        Indexing({"A", "HC"}, {0,0}, {nA, 2}, {1,0}), false);
+    auto sheet(new_ice_regridder(gridI.parameterization));
+    sheet->init("sheet", *gcm.agridA, &gridA,
+        AbbrGrid(gridI), ExchangeGrid(exgrid), InterpStyle::Z_INTERP);
+    gcm.add_sheet(std::move(sheet));
+
+    blitz::Array<double,1> elevmaskI(gcm.nI(0));
+    elevmaskI = 800.;
+    RegridParams const params(true, true, {0.,0.,0.});
+
+    // Server in a child process
+    std::string const socket_path("/tmp/icebin-test-" + std::to_string(getpid()) + ".sock");
+    pid_t const pid = fork();
+    if (pid == 0) {
+        regrid_service::RegridServer server(&gcm);
+        server.serve(socket_path);
+        _exit(0);
+    }
+
+    // Wait for it to listen
+    std::unique_ptr<regrid_service::RegridClient> client1;
+    for (int i=0; i<100 && !client1; ++i) {
+        try {
+            client1.reset(new regrid_service::RegridClient(socket_path));
+        } catch(icebin::Error const &) {
+            usleep(50000);
+        }
+    }
+    if (!client1) {
+        kill(pid, SIGKILL);
+        waitpid(pid, nullptr, 0);
+        FAIL() << "regrid_server did not start";
+    }
+
+    // A second client is served while the first stays connected
+    regrid_service::RegridClient client2(socket_path);
+    client2.ping();
+
+    // Regrid through the server...
+    blitz::Array<double,2> valI(2, gcm.nI(0));
+    for (int it=0; it<valI.extent(0); ++it)
+    for (int iI=0; iI<valI.extent(1); ++iI) valI(it,iI) = it*100 + iI;
+    blitz::Array<double,2> valA(client1->regrid("sheet", "AvI", elevmaskI, params, valI));
+
+    // ...and locally
+    auto rm(gcm.regrid_matrices(0, elevmaskI, params));
+    SparseSetT dimA, dimI;
+    auto AvI(rm->matrix_d("AvI", {&dimA, &dimI}, params));
+    blitz::Array<double,2> valI_d(valI.extent(0), dimI.dense_extent());
+    for (int it=0; it<valI.extent(0); ++it)
+    for (int iI_d=0; iI_d<dimI.dense_extent(); ++iI_d)
+        valI_d(it, iI_d) = valI(it, dimI.to_sparse(iI_d));
+    TmpAlloc tmp;
+    auto valA_d(AvI->apply(valI_d, std::numeric_limits<double>::quiet_NaN(), false, tmp));
+
+    ASSERT_EQ(valI.extent(0), valA.extent(0));
+    ASSERT_EQ(nA, valA.extent(1));
+    for (int it=0; it<valA.extent(0); ++it)
+    for (int iA_d=0; iA_d<dimA.dense_extent(); ++iA_d) {
+        EXPECT_DOUBLE_EQ(valA_d(it, iA_d), valA(it, dimA.to_sparse(iA_d)));
+    }
+
+    // A bad request fails that request, not the server
+    EXPECT_THROW(client1->regrid("nosuch", "AvI", elevmaskI, params, valI), icebin::Error);
+    client1->ping();
+
+    // A client that goes away mid-conversation does not stop the server
+    client1.reset();
+    client2.ping();
+
+    client2.shutdown_server();
+    int status = -1;
+    waitpid(pid, &status, 0);
+    EXPECT_TRUE(WIFEXITED(status));
+    EXPECT_EQ(0, WEXITSTATUS(status));
+
+    icebin_error = old_icebin_error;
+    ibmisc_error = old_ibmisc_error;
+}
+// ------------------------------------------------------------
+#if defined(BUILD_MODELE) && defined(BUILD_COUPLER)
+
+TEST_F(GridTest, ensemble_members)
+{
+    // A small ModelE-style ocean grid, with no ice sheets
+    HntrSpec const hspecO(8, 4, 0., 45.*60.);
+    Grid gridO(make_grid("O", make_grid_spec(hspecO, false, 1, 1.0)));
+    std::string const fname("__ensemble_test.nc");
+    tmpfiles.push_back(fname);
+    {
+        long const nO = gridO.ndata();
+        GCMRegridder_Standard gcmO;
+        gcmO.init(AbbrGrid(gridO), std::vector<double>{0., 1000.},
+            Indexing({"O", "HC"}, {0,0}, {nO, 2}, {1,0}), true);
+        ibmisc::NcIO ncio(fname, NcFile::replace);
+        gcmO.ncio(ncio, "m");
+        ncio.close();
+    }
+
+    // Two members reading the same grid file share one GCMRegridder_Standard
+    auto gcmO1(get_gcm_regridder(fname, "m", true));
+    auto gcmO2(get_gcm_regridder(fname, "m", true));
+    EXPECT_EQ(gcmO1.get(), gcmO2.get());
+    auto gcmO3(get_gcm_regridder(fname, "m", false));    // gcmce_new()
+    EXPECT_NE(gcmO1.get(), gcmO3.get());
+
+    // ...and one GCMRegridder_ModelE on top of it
+    auto gcmA1(get_modele_regridder("", gcmO1, true));
+    auto gcmA2(get_modele_regridder("", gcmO2, true));
+    EXPECT_EQ(gcmA1.get(), gcmA2.get());
+    EXPECT_EQ(gcmO1.get(), gcmA1->gcmO.get());
+    EXPECT_NE(gcmA1.get(), get_modele_regridder("", gcmO3, true).get());
+    EXPECT_NE(gcmA1.get(), get_modele_regridder("", gcmO1, false).get());
+}
+
+#endif // BUILD_MODELE && BUILD_COUPLER
+// ------------------------------------------------------------
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
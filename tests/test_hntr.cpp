@@ -29,6 +29,8 @@
 #include <cstdio>
 #include <fstream>
 #include <cstdlib>
+#include <limits>
+#include <cmath>
 
 using namespace std;
 using namespace ibmisc;
@@ -492,6 +494,131 @@ TEST_F(HntrTest, regrid)
     EXPECT_DOUBLE_EQ(sum4, sum8);
 
 }
+
+/** Block-sum kernel for aligned grids must agree with the general path. */
+void cmp_aligned_regrid(HntrSpec const &specA, HntrSpec const &specB, bool expect_aligned)
+{
+    auto WTA(hntr_array<double>(specA));
+    auto A(hntr_array<double>(specA));
+    for (int j=1; j<=specA.jm; ++j) {
+    for (int i=1; i<=specA.im; ++i) {
+        WTA(i,j) = (i+j) % 5 == 0 ? 0. : frand(0.,1.);
+        A(i,j) = frand(0.,1.);
+    }}
+
+    Hntr hntr(17.17, specB, specA, -1.e30);
+    EXPECT_EQ(expect_aligned, hntr.aligned);
+
+    auto Bfast(hntr_array<double>(specB));
+    hntr.regrid(WTA, A, Bfast, false, 0.5, 0.25);
+
+    hntr.block_fast_path = false;
+    auto Bgen(hntr_array<double>(specB));
+    hntr.regrid(WTA, A, Bgen, false, 0.5, 0.25);
+
+    cmp_array_rel(reshape1(Bfast,1), reshape1(Bgen,1), 1.e-13, "aligned");
+
+    // overlap() and scaled_regrid_matrix() go through matrix()
+    hntr.block_fast_path = true;
+    TupleList<int,double,2> Mfast, Sfast;
+    hntr.overlap(accum::ref(Mfast), 2.0);
+    hntr.scaled_regrid_matrix(accum::ref(Sfast));
+
+    hntr.block_fast_path = false;
+    TupleList<int,double,2> Mgen, Sgen;
+    hntr.overlap(accum::ref(Mgen), 2.0);
+    hntr.scaled_regrid_matrix(accum::ref(Sgen));
+
+    for (auto pair : {std::make_pair(&Mfast, &Mgen), std::make_pair(&Sfast, &Sgen)}) {
+        ASSERT_EQ(pair.second->size(), pair.first->size());
+        auto ii(pair.first->begin());
+        for (auto jj=pair.second->begin(); jj != pair.second->end(); ++ii, ++jj) {
+            EXPECT_EQ(jj->index(0), ii->index(0));
+            EXPECT_EQ(jj->index(1), ii->index(1));
+            EXPECT_NEAR(jj->value(), ii->value(), 1.e-13 * std::abs(jj->value()));
+        }
+    }
+}
+
+TEST_F(HntrTest, aligned_regrid)
+{
+    HntrSpec g4(8, 4, 0.0, 45.0*60);
+    HntrSpec g8(16, 8, 0.0, 22.5*60);
+    HntrSpec g8off(16, 8, 1.0, 22.5*60);
+
+    cmp_aligned_regrid(g8, g4, true);
+    cmp_aligned_regrid(g8off, g4, true);    // Block wraps around the date line
+    cmp_aligned_regrid(g1qx1, g2hx2, true);
+    cmp_aligned_regrid(g4, g8, false);
+}
+
+TEST_F(HntrTest, plan_cache)
+{
+    HntrSpec g4(8, 4, 0.0, 45.0*60);
+    HntrSpec g8(16, 8, 0.0, 22.5*60);
+    double const nan = std::numeric_limits<double>::quiet_NaN();
+
+    auto p1(hntr_plan(17.17, g4, g8));
+    EXPECT_EQ(p1.get(), hntr_plan(17.17, g4, g8).get());
+    EXPECT_NE(p1.get(), hntr_plan(17.17, g8, g4).get());
+    EXPECT_NE(p1.get(), hntr_plan(17.17, g4, g8, nan).get());
+    EXPECT_EQ(hntr_plan(17.17, g4, g8, nan).get(), hntr_plan(17.17, g4, g8, nan).get());
+
+    // Same tables as a freshly constructed Hntr
+    Hntr hntr(17.17, g4, g8);
+    for (int i=1; i<=g4.im; ++i) {
+        EXPECT_EQ(hntr.IMIN(i), p1->IMIN(i));
+        EXPECT_EQ(hntr.IMAX(i), p1->IMAX(i));
+    }
+    for (int j=0; j<=g8.jm; ++j) EXPECT_EQ(hntr.SINA(j), p1->SINA(j));
+}
+
+/** Grids with explicit (non-uniform) latitude boundaries */
+TEST_F(HntrTest, nonuniform_lat)
+{
+    // Stretched grid: finer near the equator
+    std::vector<double> latb;
+    int const jm = 12;
+    for (int j=0; j<=jm; ++j) {
+        latb.push_back(90. * sin((-.5 + (double)j/jm) * M_PI));
+    }
+    latb[0] = -90.;
+    latb[jm] = 90.;
+    HntrSpec gS(16, 0.0, std::move(latb));
+    HntrSpec g4(8, 4, 0.0, 45.0*60);
+
+    // Exact band areas add up to the sphere
+    HntrGrid gridS(gS);
+    double area = 0;
+    for (int j=1; j<=gS.jm; ++j) area += gridS.dxyp(j) * gS.im;
+    EXPECT_NEAR(1., area / (4.*M_PI), 1.e-14);
+
+    test_overlap({&gS, &g4}, false, "nonuniform");
+    test_overlap({&g4, &gS}, false, "nonuniform");
+
+    // Regridding conserves the area-weighted integral
+    auto WTS(hntr_array<double>(gS));
+    auto vS(hntr_array<double>(gS));
+    double sumS = 0;
+    for (int j=1; j<=gS.jm; ++j) {
+    for (int i=1; i<=gS.im; ++i) {
+        WTS(i,j) = 1.0;
+        vS(i,j) = frand(0.,1.);
+        sumS += vS(i,j) * gridS.dxyp(j);
+    }}
+
+    auto v4(hntr_array<double>(g4));
+    Hntr hntr(17.17, g4, gS);
+    hntr.regrid(WTS, vS, v4);
+
+    HntrGrid grid4(g4);
+    double sum4 = 0;
+    for (int j=1; j<=g4.jm; ++j) {
+    for (int i=1; i<=g4.im; ++i) {
+        sum4 += v4(i,j) * grid4.dxyp(j);
+    }}
+    EXPECT_NEAR(1., sum4/sumS, 1.e-12);
+}
 // ----------------------------------------------------------------
 
 extern "C" void write_sgeom();